@@ -10,8 +10,7 @@
     serene-drv = serene.packages."${system}".default;
     commonBuildInputs = [ serene-drv pkgs.gcc pkgs.libllvm pkgs.lld ];
     # instances = [
-    #   (import ./src/tokenvec.nix { inherit pkgs; })
-    #   (import ./src/opdeclvec.nix { inherit pkgs; })
+    #   (import ./src/opdeclvec.nix { inherit pkgs; serene = serene-drv; })
     #   (import ./src/ordstrings.nix { inherit pkgs; serene = serene-drv; })
     #   (import ./src/types.nix { inherit pkgs; serene = serene-drv; })
     # ];
@@ -22,9 +21,10 @@
         "main" 
         "mtree" 
         "tokens" 
-        "tokenvec" 
+        "literals" 
         "opdeclvec" 
         "lexer" 
+        "bytescan" 
         "ast" 
         "types" 
         "typer" 
@@ -37,7 +37,11 @@
         "ordstrings" 
         "codegen" 
         "preimport" 
+        "optable" 
         "opscan" 
+        "workers" 
+        "sched" 
+        "serene" 
       ];
       debugOpts = "-Wall -Wextra -g -O0";
       releaseOpts = "-O2";
@@ -57,7 +61,6 @@
           + "; "
           + "c++ `llvm-config --cxxflags --ldflags --libs core analysis target --system-libs` -o ./main ./*.o "
           # + pkgs.lib.concatStrings (map (d: " ${d}/lib/*") instances)
-          + " ${serene-drv}/lib/*"
         ;
       };
       default = pkgs.stdenv.mkDerivation {
@@ -69,7 +72,6 @@
           + "; "
           + "c++ `llvm-config --cxxflags --ldflags --libs core analysis target --system-libs` -o ./main ./*.o "
           # + pkgs.lib.concatStrings (map (d: " ${d}/lib/*") instances)
-          + " ${serene-drv}/lib/*"
         ;
       };
     };
@@ -43,43 +43,45 @@ btrings() {
     fi
 }
 
-# refs: btrings ordstrings
+# refs: serene
 STRINGS=0
 strings() {
     if [ "$STRINGS" -eq "0" ]; then
-        btrings
+        serene
         echo compiling strings
         $CC $OPTS -o $BUILD/strings.o -c $SRC/strings.c
         STRINGS=1
     fi
 }
 
-# refs: strings btrings ordstrings
+# refs: strings serene
+LITERALS=0
+literals() {
+    if [ "$LITERALS" -eq "0" ]; then
+        strings
+        echo compiling literals
+        $CC $OPTS -o $BUILD/literals.o -c $SRC/literals.c
+        LITERALS=1
+    fi
+}
+
+# refs: strings btrings ordstrings literals
 TOKENS=0
 tokens() {
     if [ "$TOKENS" -eq "0" ]; then
         strings
+        literals
         echo compiling tokens
         $CC $OPTS -o $BUILD/tokens.o -c $SRC/tokens.c
         TOKENS=1
     fi
 }
 
-# refs: tokens strings btrings ordstrings
-TOKENVEC=0
-tokenvec() {
-    if [ "$TOKENVEC" -eq "0" ]; then
-        tokens
-        echo compiling tokenvec
-        $CC $OPTS -o $BUILD/tokenvec.o -c $SRC/tokenvec.c
-        TOKENVEC=1
-    fi
-}
-
-# refs: NONE
+# refs: serene
 OPDECLVEC=0
 opdeclvec() {
     if [ "$OPDECLVEC" -eq "0" ]; then
+        serene
         echo compiling opdeclvec
         $CC $OPTS -o $BUILD/opdeclvec.o -c $SRC/opdeclvec.c
         OPDECLVEC=1
@@ -112,31 +114,53 @@ instances() {
     if [ "$INSTANCES" -eq "0" ]; then
         echo compiling instances
         btrings
-        tokenvec
         opdeclvec
         typereg
         INSTANCES=1
     fi
 }
 
+# refs: NONE
+BYTESCAN=0
+bytescan() {
+    if [ "$BYTESCAN" -eq "0" ]; then
+        echo compiling bytescan
+        $CC $OPTS -o $BUILD/bytescan.o -c $SRC/bytescan.c
+        BYTESCAN=1
+    fi
+}
+
 LEXER=0
 lexer() {
     if [ "$LEXER" -eq "0" ]; then
         strings
         tokens
+        bytescan
         echo compiling lexer
         $CC $OPTS -o $BUILD/lexer.o -c $SRC/lexer.c
         LEXER=1
     fi
 }
 
+# refs: serene
+WORKERS=0
+workers() {
+    if [ "$WORKERS" -eq "0" ]; then
+        serene
+        echo compiling workers
+        $CC $OPTS -o $BUILD/workers.o -c $SRC/workers.c
+        WORKERS=1
+    fi
+}
+
 OPSCAN=0
 opscan() {
     if [ "$OPSCAN" -eq "0" ]; then
         lexer
+        workers
         strings
         opdeclvec
-        tokenvec
+        tokens
         echo compiling opscan
         $CC $OPTS -o $BUILD/opscan.o -c $SRC/opscan.c
         OPSCAN=1
@@ -204,6 +228,7 @@ CODEGEN=0
 codegen() {
     if [ "$CODEGEN" -eq "0" ]; then
         strings
+        literals
         echo compiling codegen
         $CC $LLVM_CFLAGS $OPTS -o $BUILD/codegen.o -c $SRC/codegen.c
         CODEGEN=1
@@ -214,16 +239,29 @@ MTREE=0
 mtree() {
     if [ "$MTREE" -eq "0" ]; then
         serene
+        strings
         echo compiling mtree
         $CC $OPTS -o $BUILD/mtree.o -c $SRC/mtree.c
         MTREE=1
     fi
 }
 
+# refs: serene
+OPTABLE=0
+optable() {
+    if [ "$OPTABLE" -eq "0" ]; then
+        serene
+        echo compiling optable
+        $CC $OPTS -o $BUILD/optable.o -c $SRC/optable.c
+        OPTABLE=1
+    fi
+}
+
 PREIMPORT=0
 preimport() {
     if [ "$PREIMPORT" -eq "0" ]; then
         opscan
+        optable
         mtree
         strings
         echo compiling preimport
@@ -232,6 +270,20 @@ preimport() {
     fi
 }
 
+SCHED=0
+sched() {
+    if [ "$SCHED" -eq "0" ]; then
+        workers
+        preimport
+        parser
+        typer
+        literals
+        echo compiling sched
+        $CC $OPTS -o $BUILD/sched.o -c $SRC/sched.c
+        SCHED=1
+    fi
+}
+
 main() {
     echo creating build directory
     mkdir $BUILD
@@ -248,12 +300,13 @@ main() {
     ast
     parser
     typer
+    sched
     converter
     codegen
     echo compiling main
     $CC $LLVM_CFLAGS $OPTS -o $BUILD/main.o -c $SRC/main.c
     echo linking it all
-    $CXX $SANITIZER -o $BUILD/main $BUILD/*.o $LLVM_CXXFLAGS
+    $CXX $SANITIZER -pthread -o $BUILD/main $BUILD/*.o $LLVM_CXXFLAGS
 }
 
 echo compiling with $CC
@@ -25,19 +25,19 @@ void TypeIntern_print(struct TypeIntern *this) { Typereg_print(&this->tree); }
 
 struct TypeIntern TypeIntern_init(struct serene_Trea* alloc, struct Symbols syms) {
     struct Type t_unit = {.tag = TT_Tuple, .tuple = NULL};
-    struct Type t_bool = {.tag = TT_Recall, .recall = syms.s_bool};
-    struct Type t_int   = {.tag = TT_Recall, .recall = syms.s_int};
-    struct Type t_int8  = {.tag = TT_Recall, .recall = syms.s_int8};
-    struct Type t_int16 = {.tag = TT_Recall, .recall = syms.s_int16};
-    struct Type t_int32 = {.tag = TT_Recall, .recall = syms.s_int32};
-    struct Type t_int64 = {.tag = TT_Recall, .recall = syms.s_int64};
-    struct Type t_uint   = {.tag = TT_Recall, .recall = syms.s_uint};
-    struct Type t_uint8  = {.tag = TT_Recall, .recall = syms.s_uint8};
-    struct Type t_uint16 = {.tag = TT_Recall, .recall = syms.s_uint16};
-    struct Type t_uint32 = {.tag = TT_Recall, .recall = syms.s_uint32};
-    struct Type t_uint64 = {.tag = TT_Recall, .recall = syms.s_uint64};
-    struct Type t_string = {.tag = TT_Recall, .recall = syms.s_string};
-    struct Type t_star = {.tag = TT_Recall, .recall = syms.s_star};
+    struct Type t_bool = {.tag = TT_Recall, .sym = SYM_bool, .recall = syms.s_bool};
+    struct Type t_int   = {.tag = TT_Recall, .sym = SYM_int, .recall = syms.s_int};
+    struct Type t_int8  = {.tag = TT_Recall, .sym = SYM_int8, .recall = syms.s_int8};
+    struct Type t_int16 = {.tag = TT_Recall, .sym = SYM_int16, .recall = syms.s_int16};
+    struct Type t_int32 = {.tag = TT_Recall, .sym = SYM_int32, .recall = syms.s_int32};
+    struct Type t_int64 = {.tag = TT_Recall, .sym = SYM_int64, .recall = syms.s_int64};
+    struct Type t_uint   = {.tag = TT_Recall, .sym = SYM_uint, .recall = syms.s_uint};
+    struct Type t_uint8  = {.tag = TT_Recall, .sym = SYM_uint8, .recall = syms.s_uint8};
+    struct Type t_uint16 = {.tag = TT_Recall, .sym = SYM_uint16, .recall = syms.s_uint16};
+    struct Type t_uint32 = {.tag = TT_Recall, .sym = SYM_uint32, .recall = syms.s_uint32};
+    struct Type t_uint64 = {.tag = TT_Recall, .sym = SYM_uint64, .recall = syms.s_uint64};
+    struct Type t_string = {.tag = TT_Recall, .sym = SYM_string, .recall = syms.s_string};
+    struct Type t_star = {.tag = TT_Recall, .sym = SYM_star, .recall = syms.s_star};
 
     struct TypeIntern out = {0};
     out.alloc = alloc;
@@ -82,17 +82,25 @@ const struct Type *TypeIntern_intern(struct TypeIntern *this, struct Type *t) {
     return new;
 }
 
-const struct Type *Type_recall(struct TypeIntern *intern, struct String name) {
-    struct Type recall = {.tag = TT_Recall, .recall = name};
+const struct Type *Type_recall(
+    struct TypeIntern *intern, struct String name, uint32_t sym
+) {
+    struct Type recall = {.tag = TT_Recall, .sym = sym, .recall = name};
     return TypeIntern_intern(intern, &recall);
 }
 
 const struct Type* Type_forall(
     struct TypeIntern* intern,
     struct String binding,
+    uint32_t sym,
     const struct Type* body
 ) {
-    struct Type forall = {.tag = TT_Forall, .forall.binding = binding, .forall.in = body};
+    struct Type forall = {
+        .tag = TT_Forall,
+        .sym = sym,
+        .forall.binding = binding,
+        .forall.in = body,
+    };
     return TypeIntern_intern(intern, &forall);
 }
 
@@ -432,32 +440,42 @@ struct Expr Expr_mut(
     return (struct Expr) { .tag = ST_Mut, .type = type, .let = mut };
 }
 
-struct Expr Expr_recall(struct TypeIntern* intern, struct String name) {
+struct Expr Expr_recall(struct TypeIntern* intern, struct String name, uint32_t sym) {
     const struct Type* type = Type_new_typevar(intern);
-    return (struct Expr){.tag = ET_Recall, .type = type, .lit = name};
+    return (struct Expr){.tag = ET_Recall, .sym = sym, .type = type, .lit = name};
 }
 
-struct Expr Expr_number(struct TypeIntern* intern, struct String lit) {
-    return (struct Expr){.tag = ET_NumberLit, .type = intern->tsyms.t_int, .lit = lit};
+struct Expr Expr_number(
+    struct TypeIntern* intern, struct String lit, uint32_t sym, uint32_t literal
+) {
+    return (struct Expr){
+        .tag = ET_NumberLit,
+        .sym = sym,
+        .type = intern->tsyms.t_int,
+        .lit = lit,
+        .literal = literal,
+    };
 }
 
-struct Expr Expr_string(struct TypeIntern* intern, struct String lit) {
-    return (struct Expr){.tag = ET_StringLit, .type = intern->tsyms.t_string, .lit = lit};
+struct Expr Expr_string(struct TypeIntern* intern, struct String lit, uint32_t sym) {
+    return (struct Expr){.tag = ET_StringLit, .sym = sym, .type = intern->tsyms.t_string, .lit = lit};
 }
 
-struct Expr Expr_bool(struct TypeIntern* intern, struct String lit) {
-    return (struct Expr){.tag = ET_BoolLit, .type = intern->tsyms.t_bool, .lit = lit};
+struct Expr Expr_bool(struct TypeIntern* intern, struct String lit, uint32_t sym) {
+    return (struct Expr){.tag = ET_BoolLit, .sym = sym, .type = intern->tsyms.t_bool, .lit = lit};
 }
 
 struct Expr Expr_assign(
     struct serene_Trea* alloc,
     struct TypeIntern* intern,
     struct String name,
+    uint32_t sym,
     struct Expr value
 ) {
     struct ExprAssign* assign = serene_trealloc(alloc, struct ExprAssign);
     assert(assign && "OOM");
     assign->name = name;
+    assign->sym = sym;
     assign->expr = value;
     return (struct Expr) { .tag = ST_Assign, .type = intern->tsyms.t_unit, .assign = assign };
 }
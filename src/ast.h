@@ -33,12 +33,17 @@ void TypeIntern_print(struct TypeIntern*);
 struct TypeIntern TypeIntern_init(struct serene_Trea*, struct Symbols);
 const struct Type* TypeIntern_intern(struct TypeIntern*, struct Type*);
 
-const struct Type* Type_recall(struct TypeIntern *, struct String name);
+const struct Type* Type_recall(struct TypeIntern *, struct String name, uint32_t sym);
 const struct Type* Type_func(struct TypeIntern *, const struct Type *args, const struct Type *ret);
 const struct Type* Type_tuple(struct TypeIntern*, const struct Type* lhs, const struct Type* rhs);
 const struct Type* Type_tuple_extend(struct TypeIntern*, const struct Type* tail, const struct Type* head);
 const struct Type* Type_call(struct TypeIntern*, const struct Type* name, const struct Type* args);
-const struct Type* Type_forall(struct TypeIntern*, struct String binding, const struct Type* body);
+const struct Type* Type_forall(
+    struct TypeIntern*,
+    struct String binding,
+    uint32_t sym,
+    const struct Type* body
+);
 const struct Type* Type_new_typevar(struct TypeIntern*);
 
 struct Binding;
@@ -60,6 +65,7 @@ struct Binding {
         const struct Type *empty;
         struct {
             struct String name;
+            uint32_t sym;
             const struct Type *annot;
         } name;
         struct BindingTuple *tuple;
@@ -102,6 +108,8 @@ struct ExprAssign;
 
 struct Expr {
     enum ExprTag tag;
+    // symbol id of lit, for recalls and literals
+    uint32_t sym;
     const struct Type* type;
     union {
         struct ExprIf *if_expr;
@@ -109,7 +117,11 @@ struct Expr {
         struct ExprTuple tuple;
         struct Expr *loop;
         struct ExprsLL *bareblock;
-        struct String lit;
+        struct {
+            struct String lit;
+            // number literals' value, as an index into the Literals
+            uint32_t literal;
+        };
 
         struct ExprLet *let;
         struct ExprAssign *assign;
@@ -139,6 +151,7 @@ struct ExprLet {
 };
 struct ExprAssign {
     struct String name;
+    uint32_t sym;
     struct Expr expr;
 };
 
@@ -148,11 +161,17 @@ struct Expr Expr_if(struct serene_Trea*, struct Expr cond, struct Expr smash, st
 struct Expr Expr_loop(struct serene_Trea*, struct TypeIntern*, struct Expr body);
 struct Expr Expr_let(struct serene_Trea*, struct TypeIntern*, struct Binding binding, struct Expr init);
 struct Expr Expr_mut(struct serene_Trea*, struct TypeIntern*, struct Binding binding, struct Expr init);
-struct Expr Expr_recall(struct TypeIntern*, struct String name);
-struct Expr Expr_number(struct TypeIntern*, struct String lit);
-struct Expr Expr_string(struct TypeIntern*, struct String lit);
-struct Expr Expr_bool(struct TypeIntern*, struct String lit);
-struct Expr Expr_assign(struct serene_Trea*, struct TypeIntern*, struct String name, struct Expr value);
+struct Expr Expr_recall(struct TypeIntern*, struct String name, uint32_t sym);
+struct Expr Expr_number(struct TypeIntern*, struct String lit, uint32_t sym, uint32_t literal);
+struct Expr Expr_string(struct TypeIntern*, struct String lit, uint32_t sym);
+struct Expr Expr_bool(struct TypeIntern*, struct String lit, uint32_t sym);
+struct Expr Expr_assign(
+    struct serene_Trea*,
+    struct TypeIntern*,
+    struct String name,
+    uint32_t sym,
+    struct Expr value
+);
 struct Expr Expr_break(struct serene_Trea*, struct TypeIntern*, struct Expr body);
 struct Expr Expr_return(struct serene_Trea*, struct TypeIntern*, struct Expr body);
 struct Expr Expr_const(struct serene_Trea*, struct TypeIntern*, struct Expr body);
@@ -161,6 +180,7 @@ struct Expr Expr_tuple_extend(struct serene_Trea*, struct TypeIntern *, struct E
 
 struct Function {
     struct String name;
+    uint32_t sym;
     struct Type const *ret;
     struct Binding args;
     struct Expr body;
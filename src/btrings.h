@@ -12,8 +12,22 @@ struct Btrings {
 };
 
 bool Btrings_insert(struct Btrings *, struct serene_Allocator, struct Ordstring);
+// elems have to be strictly ascending and the tree empty
+bool Btrings_from_sorted(
+    struct Btrings *, struct serene_Allocator, struct Ordstring const *, size_t
+);
 struct Ordstring *Btrings_search(struct Btrings *, struct Ordstring);
 void Btrings_deinit(struct Btrings *, struct serene_Allocator);
+
+// walks the keys in ascending order, next returns NULL past the last one;
+// inserting invalidates it
+struct Btrings_iter {
+    struct Btrings_impl *node;
+    int i;
+};
+
+struct Btrings_iter Btrings_first(struct Btrings *);
+struct Ordstring *Btrings_next(struct Btrings_iter *);
 void Btrings_print(struct Btrings *);
 
 #endif
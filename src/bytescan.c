@@ -0,0 +1,152 @@
+#include "bytescan.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __x86_64__
+#include <immintrin.h>
+#define BYTESCAN_X86
+#endif
+
+enum Bytescan {
+    BS_Newline,
+    BS_String,
+    BS_Space,
+    BS_Word,
+};
+
+#define inline_always static inline __attribute__((always_inline))
+
+inline_always bool scalar_match(enum Bytescan kind, uint8_t c) {
+    switch (kind) {
+    case BS_Newline:
+        return c == '\n';
+    case BS_String:
+        return c == '"' || c == '\\' || c == '\n';
+    case BS_Space:
+        return c != ' ' && c != '\n';
+    case BS_Word:
+        return c <= ';' || c == '[' || c == ']' || c == '{' || c == '}';
+    }
+    return true;
+}
+
+inline_always size_t scalar_scan(
+    enum Bytescan kind, const char* str, size_t i, size_t len
+) {
+    while (i < len && !scalar_match(kind, str[i])) i++;
+    return i;
+}
+
+#ifdef BYTESCAN_X86
+
+inline_always __m128i sse2_match(enum Bytescan kind, __m128i v) {
+#define eq(c) _mm_cmpeq_epi8(v, _mm_set1_epi8(c))
+#define or(a, b) _mm_or_si128(a, b)
+    switch (kind) {
+    case BS_Newline:
+        return eq('\n');
+    case BS_String:
+        return or(or(eq('"'), eq('\\')), eq('\n'));
+    case BS_Space:
+        return _mm_andnot_si128(or(eq(' '), eq('\n')), _mm_set1_epi8(-1));
+    case BS_Word: {
+        // no unsigned compare, but min(v, ';') == v is v <= ';'
+        __m128i low = _mm_cmpeq_epi8(_mm_min_epu8(v, _mm_set1_epi8(';')), v);
+        return or(or(low, or(eq('['), eq(']'))), or(eq('{'), eq('}')));
+    }
+    }
+#undef or
+#undef eq
+    return _mm_set1_epi8(-1);
+}
+
+inline_always size_t sse2_scan(enum Bytescan kind, const char* str, size_t len) {
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*) (str + i));
+        unsigned mask = _mm_movemask_epi8(sse2_match(kind, v));
+        if (mask) return i + __builtin_ctz(mask);
+    }
+    return scalar_scan(kind, str, i, len);
+}
+
+__attribute__((target("avx2")))
+inline_always __m256i avx2_match(enum Bytescan kind, __m256i v) {
+#define eq(c) _mm256_cmpeq_epi8(v, _mm256_set1_epi8(c))
+#define or(a, b) _mm256_or_si256(a, b)
+    switch (kind) {
+    case BS_Newline:
+        return eq('\n');
+    case BS_String:
+        return or(or(eq('"'), eq('\\')), eq('\n'));
+    case BS_Space:
+        return _mm256_andnot_si256(or(eq(' '), eq('\n')), _mm256_set1_epi8(-1));
+    case BS_Word: {
+        __m256i low = _mm256_cmpeq_epi8(_mm256_min_epu8(v, _mm256_set1_epi8(';')), v);
+        return or(or(low, or(eq('['), eq(']'))), or(eq('{'), eq('}')));
+    }
+    }
+#undef or
+#undef eq
+    return _mm256_set1_epi8(-1);
+}
+
+__attribute__((target("avx2")))
+inline_always size_t avx2_scan(enum Bytescan kind, const char* str, size_t len) {
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*) (str + i));
+        unsigned mask = _mm256_movemask_epi8(avx2_match(kind, v));
+        if (mask) return i + __builtin_ctz(mask);
+    }
+    // the sse2 loop still takes a half sized tail
+    for (; i + 16 <= len; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*) (str + i));
+        unsigned mask = _mm_movemask_epi8(sse2_match(kind, v));
+        if (mask) return i + __builtin_ctz(mask);
+    }
+    return scalar_scan(kind, str, i, len);
+}
+
+// the kind is a constant at every call site,
+// so each instance boils down to its own loops
+#define BYTESCAN(kind)                                                         \
+    __attribute__((target("avx2"))) static size_t avx2_##kind(                \
+        const char* str, size_t len                                            \
+    ) {                                                                        \
+        return avx2_scan(kind, str, len);                                      \
+    }                                                                          \
+    static size_t scan_##kind(const char* str, size_t len) {                   \
+        if (__builtin_cpu_supports("avx2")) return avx2_##kind(str, len);      \
+        return sse2_scan(kind, str, len);                                      \
+    }
+
+#else
+
+#define BYTESCAN(kind)                                                         \
+    static size_t scan_##kind(const char* str, size_t len) {                   \
+        return scalar_scan(kind, str, 0, len);                                 \
+    }
+
+#endif
+
+BYTESCAN(BS_Newline)
+BYTESCAN(BS_String)
+BYTESCAN(BS_Space)
+BYTESCAN(BS_Word)
+
+size_t bytescan_newline(const char* str, size_t len) {
+    return scan_BS_Newline(str, len);
+}
+
+size_t bytescan_string(const char* str, size_t len) {
+    return scan_BS_String(str, len);
+}
+
+size_t bytescan_space(const char* str, size_t len) {
+    return scan_BS_Space(str, len);
+}
+
+size_t bytescan_word(const char* str, size_t len) {
+    return scan_BS_Word(str, len);
+}
@@ -0,0 +1,20 @@
+#ifndef BYTESCAN_H
+#define BYTESCAN_H
+
+#include <stddef.h>
+
+// each returns the index of the first byte in str[0..len)
+// it's looking for, or len if there is none;
+// picks avx2 or sse2 at runtime, where there's neither it's a plain loop
+
+// '\n'
+size_t bytescan_newline(const char* str, size_t len);
+// '"', '\\' or '\n'
+size_t bytescan_string(const char* str, size_t len);
+// anything but ' ' and '\n', so it may stop early on other whitespace
+size_t bytescan_space(const char* str, size_t len);
+// anything up to ';' and the brackets and braces,
+// so it may stop early on punctuation that's part of a word
+size_t bytescan_word(const char* str, size_t len);
+
+#endif
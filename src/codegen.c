@@ -2,6 +2,7 @@
 
 #include "./common_ll.h"
 #include "./strings.h"
+#include "./symbols.h"
 
 #include <assert.h>
 #include <llvm-c/Analysis.h>
@@ -19,6 +20,10 @@ struct Ctx {
         LLVMValueRef fval;
         LLVMTypeRef ftype;
     }* funcs;
+    // function values by symbol id, NULL if there's none
+    LLVMValueRef* fvals;
+    uint32_t fvals_len;
+    const struct Literals* literals;
     LLVMTypeRef t_unit;
     LLVMValueRef v_unit;
 };
@@ -26,14 +31,21 @@ struct Ctx {
 static LLVMTypeRef lower_type(struct Ctx* ctx, struct tst_Type* type);
 static void lower_function(struct Ctx* ctx, struct tst_Function* func, LLVMValueRef fvar, LLVMTypeRef ftype);
 
-LLVMModuleRef lower(struct Tst* tst, struct serene_Trea alloc) {
+LLVMModuleRef lower(struct Tst* tst, const struct Literals* literals, struct serene_Trea alloc) {
     struct Ctx ctx = {
         .alloc = &alloc,
         .mod = LLVMModuleCreateWithName("mod"),
         .funcs = NULL,
+        .literals = literals,
         .t_unit = LLVMStructType(NULL, 0, false),
     };
     ctx.v_unit = LLVMConstNamedStruct(ctx.t_unit, NULL, 0);
+    for (ll_iter(f, tst->funcs)) {
+        if (f->current.sym >= ctx.fvals_len) ctx.fvals_len = f->current.sym + 1;
+    }
+    ctx.fvals = serene_trenalloc(ctx.alloc, ctx.fvals_len, LLVMValueRef);
+    assert(ctx.fvals && "OOM");
+    for (uint32_t i = 0; i < ctx.fvals_len; i++) ctx.fvals[i] = NULL;
     for (ll_iter(f, tst->funcs)) {
         LLVMTypeRef type = lower_type(&ctx, &f->current.type);
         LLVMValueRef val = LLVMAddFunction(ctx.mod, f->current.name.str, type);
@@ -44,6 +56,7 @@ LLVMModuleRef lower(struct Tst* tst, struct serene_Trea alloc) {
         tmp->ftype = type;
         tmp->fval = val;
         ctx.funcs = tmp;
+        ctx.fvals[f->current.sym] = val;
     }
     for (ll_iter(f, ctx.funcs)) {
         lower_function(&ctx, f->f, f->fval, f->ftype);
@@ -82,6 +95,8 @@ static LLVMTypeRef lower_TTT_Star(struct Ctx* ctx, struct tst_TypeStar* type) {
     int count = 0;
     for (ll_iter(head, type)) count++;
 
+    // llvm copies the element types
+    struct serene_TreaMark mark = serene_Trea_mark(ctx->alloc);
     LLVMTypeRef* elems = serene_trenalloc(ctx->alloc, count, LLVMTypeRef);
     assert(elems && "OOM");
     int idx = 0;
@@ -89,7 +104,9 @@ static LLVMTypeRef lower_TTT_Star(struct Ctx* ctx, struct tst_TypeStar* type) {
         elems[idx] = lower_type(ctx, &head->current);
     }
 
-    return LLVMStructType(elems, count, false);
+    LLVMTypeRef out = LLVMStructType(elems, count, false);
+    serene_Trea_reset(ctx->alloc, mark);
+    return out;
 }
 
 static LLVMTypeRef lower_TTT_Func(struct Ctx* ctx, struct tst_TypeFunc* type) {
@@ -104,9 +121,11 @@ struct FCtx {
     LLVMValueRef f;
     LLVMValueRef v_ret;
     LLVMBasicBlockRef b_ret;
+    struct serene_Pool* nodes;
     struct LetsLL {
         struct LetsLL* next;
         struct String name;
+        uint32_t sym;
         LLVMValueRef slot;
         LLVMTypeRef type;
     }* lets;
@@ -143,8 +162,13 @@ static void lower_function(
     LLVMValueRef fval,
     LLVMTypeRef ftype
 ) {
+    // nothing in here outlives the function,
+    // so the next one gets to reuse the same memory
+    struct serene_TreaMark mark = serene_Trea_mark(ctx->alloc);
+    struct serene_Pool nodes = serene_Pool_init(serene_Trea_dyn(ctx->alloc));
     struct FCtx fctx = {
         .ctx = ctx,
+        .nodes = &nodes,
         .b = LLVMCreateBuilder(),
         .f = fval,
         .lets = NULL,
@@ -170,16 +194,19 @@ static void lower_function(
     LLVMValueRef v_ret = LLVMBuildLoad2(fctx.b, t_ret, fctx.v_ret, "*v_ret");
     LLVMBuildRet(fctx.b, v_ret);
     LLVMDisposeBuilder(fctx.b);
+
+    serene_Pool_deinit(&nodes);
+    serene_Trea_reset(ctx->alloc, mark);
 }
 
-static struct Control lower_TET_BoolLit(struct FCtx* ctx, struct String lit),
-    lower_TET_NumberLit(struct FCtx* ctx, struct String lit),
+static struct Control lower_TET_BoolLit(struct FCtx* ctx, uint32_t sym),
+    lower_TET_NumberLit(struct FCtx* ctx, struct String lit, uint32_t literal, struct tst_Type* type),
     lower_TET_StringLit(struct FCtx* ctx, struct String lit),
     lower_TET_If(struct FCtx* ctx, struct tst_ExprIf* expr),
     lower_TET_Loop(struct FCtx* ctx, struct tst_Expr* body, struct tst_Type* type),
     lower_TET_Bareblock(struct FCtx* ctx, struct tst_ExprsLL* body),
     lower_TET_Call(struct FCtx* ctx, struct tst_ExprCall* expr),
-    lower_TET_Recall(struct FCtx* ctx, struct String lit),
+    lower_TET_Recall(struct FCtx* ctx, uint32_t sym),
     lower_TET_Tuple(struct FCtx* ctx, struct tst_ExprTuple* expr, struct tst_Type* type),
     lower_TET_Builtin(struct FCtx* ctx, enum tst_ExprBuiltin built),
     lower_TST_Let(struct FCtx* ctx, struct tst_ExprLet* expr),
@@ -193,14 +220,14 @@ static struct Control lower_expr(struct tst_Expr* expr, struct FCtx* ctx) {
     case Tag: return lower_##Tag(ctx, __VA_ARGS__);
 
     switch (expr->tag) {
-        Case(TET_BoolLit, expr->lit);
-        Case(TET_NumberLit, expr->lit);
+        Case(TET_BoolLit, expr->sym);
+        Case(TET_NumberLit, expr->lit, expr->literal, &expr->type);
         Case(TET_StringLit, expr->lit);
         Case(TET_If, expr->if_expr);
         Case(TET_Loop, expr->loop, &expr->type);
         Case(TET_Bareblock, expr->bareblock);
         Case(TET_Call, expr->call);
-        Case(TET_Recall, expr->lit);
+        Case(TET_Recall, expr->sym);
         Case(TET_Tuple, expr->tuple, &expr->type);
         Case(TET_Builtin, expr->builtin);
         Case(TST_Let, expr->let);
@@ -214,17 +241,24 @@ static struct Control lower_expr(struct tst_Expr* expr, struct FCtx* ctx) {
     assert(false && "shouldn't");
 }
 
-static struct Control lower_TET_BoolLit(struct FCtx* ctx, struct String lit) {
+static struct Control lower_TET_BoolLit(struct FCtx* ctx, uint32_t sym) {
     (void) ctx;
     int b = 0;
-    if (strings_equal(lit, (struct String){"true", 4})) b = 1;
+    if (sym == SYM_true) b = 1;
     return Control_plain(LLVMConstInt(LLVMInt1Type(), b, false));
 }
 
-static struct Control lower_TET_NumberLit(struct FCtx* ctx, struct String lit) {
-    (void) ctx;
-    unsigned long long n = atoi(lit.str);
-    return Control_plain(LLVMConstInt(LLVMInt64Type(), n, false));
+static struct Control lower_TET_NumberLit(
+    struct FCtx* ctx, struct String lit, uint32_t literal, struct tst_Type* type
+) {
+    LLVMTypeRef llvm_type = lower_type(ctx->ctx, type);
+    struct Literal value = Literals_get(ctx->ctx->literals, literal);
+    unsigned bits = LLVMGetIntTypeWidth(llvm_type);
+    if (!Literal_fits(value, bits)) {
+        printf("Number literal '%.*s' doesn't fit in %u bits!\n", (int) lit.len, lit.str, bits);
+        assert(false);
+    }
+    return Control_plain(LLVMConstIntOfArbitraryPrecision(llvm_type, Literal_words, value.words));
 }
 
 static struct Control lower_TET_StringLit(struct FCtx* ctx, struct String lit) {
@@ -286,7 +320,7 @@ static struct Control lower_TET_Loop(struct FCtx* ctx, struct tst_Expr* body, st
     LLVMValueRef v_break = LLVMBuildAlloca(ctx->b, t_break, "");
     LLVMBasicBlockRef b_loop = LLVMAppendBasicBlock(ctx->f, "");
     LLVMBasicBlockRef b_post = LLVMAppendBasicBlock(ctx->f, "");
-    struct LoopsLL* tmp = serene_trealloc(ctx->ctx->alloc, struct LoopsLL);
+    struct LoopsLL* tmp = serene_poolalloc(ctx->nodes, struct LoopsLL);
     assert(tmp && "OOM");
     tmp->next = ctx->loops;
     tmp->v_break = v_break;
@@ -296,12 +330,13 @@ static struct Control lower_TET_Loop(struct FCtx* ctx, struct tst_Expr* body, st
     LLVMBuildBr(ctx->b, b_loop);
     LLVMPositionBuilderAtEnd(ctx->b, b_loop);
     struct Control v = lower_expr(body, ctx);
+    ctx->loops = tmp->next;
+    serene_poolfree(ctx->nodes, tmp);
     if (v.tag == CT_Return) return v;
     if (v.tag == CT_Plain) {
         LLVMBuildBr(ctx->b, b_loop);
     }
     LLVMPositionBuilderAtEnd(ctx->b, b_post);
-    ctx->loops = ctx->loops->next;
     return Control_plain(LLVMBuildLoad2(ctx->b, t_break, v_break, ""));
 }
 
@@ -385,16 +420,14 @@ static struct Control lower_TET_Call(struct FCtx* ctx, struct tst_ExprCall* expr
     return Control_plain(res);
 }
 
-static struct Control lower_TET_Recall(struct FCtx* ctx, struct String lit) {
+static struct Control lower_TET_Recall(struct FCtx* ctx, uint32_t sym) {
     for (ll_iter(head, ctx->lets)) {
-        if (head->name.str == lit.str) {
+        if (head->sym == sym) {
             return Control_plain(LLVMBuildLoad2(ctx->b, head->type, head->slot, head->name.str));
         }
     }
-    for (ll_iter(head, ctx->ctx->funcs)) {
-        if (head->f->name.str == lit.str) {
-            return Control_plain(head->fval);
-        }
+    if (sym < ctx->ctx->fvals_len && ctx->ctx->fvals[sym]) {
+        return Control_plain(ctx->ctx->fvals[sym]);
     }
     assert(false && "no such name found, something in typer must've gone wrong!");
 }
@@ -443,7 +476,7 @@ static struct Control lower_TST_Return(struct FCtx* ctx, struct tst_Expr* body)
 
 static struct Control lower_TST_Assign(struct FCtx* ctx, struct tst_ExprAssign* expr) {
     for (ll_iter(head, ctx->lets)) {
-        if (head->name.str == expr->name.str) {
+        if (head->sym == expr->sym) {
             struct Control val = lower_expr(&expr->expr, ctx);
             if (val.tag == CT_Break || val.tag == CT_Return) return val;
             LLVMBuildStore(ctx->b, val.val, head->slot);
@@ -470,10 +503,11 @@ static void lower_binding(
             LLVMTypeRef type = lower_type(ctx->ctx, &binding->name.type);
             LLVMValueRef loc = LLVMBuildAlloca(ctx->b, type, "");
             LLVMBuildStore(ctx->b, val, loc);
-            struct LetsLL* tmp = serene_trealloc(ctx->ctx->alloc, struct LetsLL);
+            struct LetsLL* tmp = serene_poolalloc(ctx->nodes, struct LetsLL);
             assert(tmp && "OOM");
             tmp->next = ctx->lets;
             tmp->name = binding->name.name;
+            tmp->sym = binding->name.sym;
             tmp->slot = loc;
             tmp->type = type;
             ctx->lets = tmp;
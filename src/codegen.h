@@ -1,10 +1,11 @@
 #ifndef CODEGEN_H
 #define CODEGEN_H
 
+#include "literals.h"
 #include "tst.h"
 #include "serene.h"
 #include <llvm-c/Core.h>
 
-LLVMModuleRef lower(struct Tst *, struct serene_Trea alloc);
+LLVMModuleRef lower(struct Tst *, const struct Literals*, struct serene_Trea alloc);
 
 #endif
@@ -63,6 +63,7 @@ static struct tst_Function convert_func(struct Context *ctx, struct Function fun
     }
     return (struct tst_Function){
         .name = func.name,
+        .sym = func.sym,
         .type = type,
         .args = args,
         .body = body,
@@ -73,7 +74,7 @@ static struct tst_Expr convert_ET_If(struct Context* ctx, struct ExprIf* expr, s
     convert_ET_Loop(struct Context* ctx, struct Expr* body, struct tst_Type type),
     convert_ET_Bareblock(struct Context* ctx, struct ExprsLL* body, struct tst_Type type),
     convert_ET_Call(struct Context* ctx, struct ExprCall* expr, struct tst_Type type),
-    convert_ET_Recall(struct Context *ctx, struct String lit, struct tst_Type type),
+    convert_ET_Recall(struct Context *ctx, struct String lit, uint32_t sym, struct tst_Type type),
     convert_ET_Tuple(struct Context *ctx, struct ExprTuple expr, struct tst_Type type),
     convert_ST_Let(struct Context *ctx, struct ExprLet *expr, struct tst_Type type),
     convert_ST_Break(struct Context *ctx, struct Expr *body, struct tst_Type type),
@@ -92,7 +93,7 @@ static struct tst_Expr convert_expr(struct Context *ctx, struct Expr *expr) {
         Case(ET_Loop, expr->loop, type);
         Case(ET_Bareblock, expr->bareblock, type);
         Case(ET_Call, expr->call, type);
-        Case(ET_Recall, expr->lit, type);
+        Case(ET_Recall, expr->lit, expr->sym, type);
         Case(ET_Tuple, expr->tuple, type);
         Case(ST_Break, expr->break_stmt, type);
         Case(ST_Return, expr->return_stmt, type);
@@ -105,16 +106,20 @@ static struct tst_Expr convert_expr(struct Context *ctx, struct Expr *expr) {
 
     case ET_NumberLit: return (struct tst_Expr){
         .tag = TET_NumberLit,
+        .sym = expr->sym,
         .type = type,
         .lit = expr->lit,
+        .literal = expr->literal,
     };
     case ET_StringLit: return (struct tst_Expr){
         .tag = TET_StringLit,
+        .sym = expr->sym,
         .type = type,
         .lit = expr->lit,
     };
     case ET_BoolLit: return (struct tst_Expr){
         .tag = TET_BoolLit,
+        .sym = expr->sym,
         .type = type,
         .lit = expr->lit,
     };
@@ -183,42 +188,30 @@ static struct tst_Expr convert_ET_Call(struct Context* ctx, struct ExprCall* exp
 }
 
 
-static struct tst_Expr convert_ET_Recall(struct Context* ctx, struct String lit, struct tst_Type type) {
-#define builtin(sym) \
-    (lit.str == ctx->intern->syms.sym.str)
-#define mk_builtin(def) \
-    { return (struct tst_Expr){.tag = TET_Builtin, .builtin = def}; }
-
-    if builtin (s_badd) mk_builtin(EB_badd);
-    if builtin (s_bsub) mk_builtin(EB_bsub);
-    if builtin (s_bmul) mk_builtin(EB_bmul);
-    if builtin (s_bdiv) mk_builtin(EB_bdiv);
-    if builtin (s_bmod) mk_builtin(EB_bmod);
-    if builtin (s_bneg) mk_builtin(EB_bneg);
-    if builtin (s_band) mk_builtin(EB_band);
-    if builtin (s_bor) mk_builtin(EB_bor);
-    if builtin (s_bxor) mk_builtin(EB_bxor);
-    if builtin (s_bnot) mk_builtin(EB_bnot);
-    if builtin (s_bshl) mk_builtin(EB_bshl);
-    if builtin (s_bshr) mk_builtin(EB_bshr);
-    if builtin (s_bcmpEQ) mk_builtin(EB_bcmpEQ);
-    if builtin (s_bcmpNE) mk_builtin(EB_bcmpNE);
-    if builtin (s_bcmpGT) mk_builtin(EB_bcmpGT);
-    if builtin (s_bcmpLT) mk_builtin(EB_bcmpLT);
-    if builtin (s_bcmpGE) mk_builtin(EB_bcmpGE);
-    if builtin (s_bcmpLE) mk_builtin(EB_bcmpLE);
-    if builtin (s_syscall) mk_builtin(EB_syscall);
-    if builtin (s_bptr_to_int) mk_builtin(EB_ptr_to_int);
-    if builtin (s_bint_to_ptr) mk_builtin(EB_int_to_ptr);
+static struct tst_Expr convert_ET_Recall(
+    struct Context* ctx,
+    struct String lit,
+    uint32_t sym,
+    struct tst_Type type
+) {
+    (void) ctx;
+    static_assert(
+        SYM_bint_to_ptr - SYM_badd == EB_int_to_ptr - EB_badd,
+        "builtin symbols and enum tst_ExprBuiltin have to line up"
+    );
+    if (SYM_badd <= sym && sym <= SYM_bint_to_ptr) {
+        return (struct tst_Expr){
+            .tag = TET_Builtin,
+            .builtin = EB_badd + (sym - SYM_badd),
+        };
+    }
 
     return (struct tst_Expr){
         .tag = TET_Recall,
+        .sym = sym,
         .type = type,
         .lit = lit
     };
-
-#undef mk_builtin
-#undef builtin
 }
 
 static struct tst_Expr convert_ET_Tuple(struct Context* ctx, struct ExprTuple expr, struct tst_Type type) {
@@ -279,6 +272,7 @@ static struct tst_Expr convert_ST_Assign(struct Context* ctx, struct ExprAssign*
     assert(assign && "OOM");
     assign->expr = convert_expr(ctx, &expr->expr);
     assign->name = expr->name;
+    assign->sym = expr->sym;
     return (struct tst_Expr){
         .tag = TST_Assign,
         .type = type,
@@ -308,6 +302,7 @@ convert_binding(struct Context *ctx, struct Binding binding) {
         return (struct tst_Binding){
             .tag = TBT_Name,
             .name.name = binding.name.name,
+            .name.sym = binding.name.sym,
             .name.type = convert_type(ctx, binding.name.annot, NULL),
         };
     case BT_Tuple: {
@@ -328,7 +323,7 @@ convert_binding(struct Context *ctx, struct Binding binding) {
     assert(false && "christ");
 }
 
-static struct tst_Type convert_TT_Recall(struct Context* ctx, struct String lit, const struct Type* params),
+static struct tst_Type convert_TT_Recall(struct Context* ctx, uint32_t sym, const struct Type* params),
     convert_TT_Func(struct Context* ctx, const struct TypeFunc* func);
 
 static struct tst_Type convert_type(
@@ -337,7 +332,7 @@ static struct tst_Type convert_type(
     switch (type->tag) {
     case TT_Forall: assert(false && "TODO: Monomorphization");
     case TT_Var: assert(false && "should've been eliminated in fill_type");
-    case TT_Recall: return convert_TT_Recall(ctx, type->recall, params);
+    case TT_Recall: return convert_TT_Recall(ctx, type->sym, params);
     case TT_Func: return convert_TT_Func(ctx, &type->func);
     case TT_Call:
         assert(!params && "should have no parameters");
@@ -353,35 +348,23 @@ static struct tst_Type convert_type(
 }
 
 
-static struct tst_Type convert_TT_Recall(struct Context* ctx, struct String lit, const struct Type* params) {
+static struct tst_Type convert_TT_Recall(struct Context* ctx, uint32_t sym, const struct Type* params) {
     enum tst_TypeTag tag;
-    if (ctx->intern->syms.s_unit.str == lit.str) {
-        assert(false && "this should not be possible anymore");
-    } else if (ctx->intern->syms.s_int.str == lit.str) {
-        tag = TTT_Int;
-    } else if (ctx->intern->syms.s_int8.str == lit.str) {
-        tag = TTT_Int8;
-    } else if (ctx->intern->syms.s_int16.str == lit.str) {
-        tag = TTT_Int16;
-    } else if (ctx->intern->syms.s_int32.str == lit.str) {
-        tag = TTT_Int32;
-    } else if (ctx->intern->syms.s_int64.str == lit.str) {
-        tag = TTT_Int64;
-    } else if (ctx->intern->syms.s_uint.str == lit.str) {
-        tag = TTT_Int;
-    } else if (ctx->intern->syms.s_uint8.str == lit.str) {
-        tag = TTT_Int8;
-    } else if (ctx->intern->syms.s_uint16.str == lit.str) {
-        tag = TTT_Int16;
-    } else if (ctx->intern->syms.s_uint32.str == lit.str) {
-        tag = TTT_Int32;
-    } else if (ctx->intern->syms.s_uint64.str == lit.str) {
-        tag = TTT_Int64;
-    } else if (ctx->intern->syms.s_bool.str == lit.str) {
-        tag = TTT_Bool;
-    } else if (ctx->intern->syms.s_string.str == lit.str) {
-        tag = TTT_String;
-    } else if (ctx->intern->syms.s_star.str == lit.str) {
+    switch (sym) {
+    case SYM_unit: assert(false && "this should not be possible anymore");
+    case SYM_int: tag = TTT_Int; break;
+    case SYM_int8: tag = TTT_Int8; break;
+    case SYM_int16: tag = TTT_Int16; break;
+    case SYM_int32: tag = TTT_Int32; break;
+    case SYM_int64: tag = TTT_Int64; break;
+    case SYM_uint: tag = TTT_Int; break;
+    case SYM_uint8: tag = TTT_Int8; break;
+    case SYM_uint16: tag = TTT_Int16; break;
+    case SYM_uint32: tag = TTT_Int32; break;
+    case SYM_uint64: tag = TTT_Int64; break;
+    case SYM_bool: tag = TTT_Bool; break;
+    case SYM_string: tag = TTT_String; break;
+    case SYM_star: {
         assert(
             params && params->tag == TT_Tuple && "expected parameters"
         );
@@ -400,7 +383,8 @@ static struct tst_Type convert_TT_Recall(struct Context* ctx, struct String lit,
             .tag = TTT_Star,
             .star = list,
         };
-    } else {
+    }
+    default:
         assert(false && "TODO");
     }
     assert(!params && "expected no parameters");
@@ -1,212 +1,204 @@
 #include "./lexer.h"
 #include "./strings.h"
-#include <assert.h>
-#include <stdlib.h>
+#include "bytescan.h"
+#include <stdint.h>
+
+// what a byte can start, a token is picked from
+// the class of its first byte alone
+enum LexClass {
+    // everything not listed below, names and operators are made of these
+    LC_Word = 0,
+    LC_Nul,
+    LC_Space,
+    LC_Digit,
+    LC_Quote,
+    LC_Immediate,
+    // the immediate or the start of a comment
+    LC_Slash,
+    // part of a word, unless it starts an ellipsis
+    LC_Dot,
+};
 
-struct SpellingEntry;
+static const uint8_t classes[256] = {
+    ['\0'] = LC_Nul,
+    ['\t'] = LC_Space,
+    ['\n'] = LC_Space,
+    ['\f'] = LC_Space,
+    ['\r'] = LC_Space,
+    [' '] = LC_Space,
+    ['0' ... '9'] = LC_Digit,
+    ['"'] = LC_Quote,
+    ['('] = LC_Immediate,
+    [')'] = LC_Immediate,
+    ['{'] = LC_Immediate,
+    ['}'] = LC_Immediate,
+    ['['] = LC_Immediate,
+    [']'] = LC_Immediate,
+    [','] = LC_Immediate,
+    [';'] = LC_Immediate,
+    [':'] = LC_Immediate,
+    ['/'] = LC_Slash,
+    ['.'] = LC_Dot,
+};
 
-static bool lexer_is_word_break(char);
-static struct String lexer_strip_whitespace(struct String);
-static bool lexer_immediates(struct Lexer*, struct String);
-static bool lexer_comment(struct Lexer *, struct String);
-static bool lexer_keywords(struct Lexer*, struct String);
-static bool lexer_bools(struct Lexer*, struct String);
-static bool lexer_string(struct Lexer*, struct String);
-static bool lexer_number(struct Lexer*, struct String);
-static bool lexer_name(struct Lexer*, struct String);
+static const enum Tokenkind immediates[256] = {
+    ['('] = TK_OpenParen,
+    [')'] = TK_CloseParen,
+    ['{'] = TK_OpenBrace,
+    ['}'] = TK_CloseBrace,
+    ['['] = TK_OpenBracket,
+    [']'] = TK_CloseBracket,
+    [','] = TK_Comma,
+    [';'] = TK_Semicolon,
+    [':'] = TK_Colon,
+    ['/'] = TK_Slash,
+};
 
-struct Token Lexer_next(struct Lexer* lexer) {
-    if (lexer->rest.len == 0) return (struct Token){0};
-    lexer->rest = lexer_strip_whitespace(lexer->rest);
-    if (lexer_comment(lexer, lexer->rest) ||
-        lexer_immediates(lexer, lexer->rest) ||
-        lexer_keywords(lexer, lexer->rest) ||
-        lexer_bools(lexer, lexer->rest) ||
-        lexer_string(lexer, lexer->rest) ||
-        lexer_number(lexer, lexer->rest) ||
-        lexer_name(lexer, lexer->rest)) {
-        return lexer->token;
-    }
-    return (struct Token) {0};
-}
+#define lexer_class(c) classes[(uint8_t) (c)]
+#define lexer_in(c, set) ((1u << lexer_class(c)) & (set))
+// keywords end at anything outside of these,
+// names carry on through digits as well
+#define LS_Word ((1u << LC_Word) | (1u << LC_Dot))
+#define LS_Name (LS_Word | (1u << LC_Digit))
 
 struct SpellingEntry {
     struct String str;
     enum Tokenkind kind;
 };
 
-const struct SpellingEntry immediates[] = {
+// no two keywords share a slot, see lexer_hash;
+// the empty slots never match since words aren't empty
+static const struct SpellingEntry keywords[32] = {
 #define mkString(s) {.str = s, .len = sizeof(s) - 1}
-    {.str = mkString("("), .kind = TK_OpenParen},
-    {.str = mkString(")"), .kind = TK_CloseParen},
-    {.str = mkString("{"), .kind = TK_OpenBrace},
-    {.str = mkString("}"), .kind = TK_CloseBrace},
-    {.str = mkString("["), .kind = TK_OpenBracket},
-    {.str = mkString("]"), .kind = TK_CloseBracket},
-    {.str = mkString(","), .kind = TK_Comma},
-    {.str = mkString(";"), .kind = TK_Semicolon},
-    {.str = mkString(":"), .kind = TK_Colon},
-    {.str = mkString("/"), .kind = TK_Slash},
-    {.str = mkString("..."), .kind = TK_Ellipsis},
+    [0] = {.str = mkString("let"), .kind = TK_Let},
+    [1] = {.str = mkString("mut"), .kind = TK_Mut},
+    [2] = {.str = mkString("type"), .kind = TK_Type},
+    [6] = {.str = mkString("false"), .kind = TK_Bool},
+    [7] = {.str = mkString("as"), .kind = TK_As},
+    [8] = {.str = mkString("true"), .kind = TK_Bool},
+    [12] = {.str = mkString("return"), .kind = TK_Return},
+    [17] = {.str = mkString("if"), .kind = TK_If},
+    [19] = {.str = mkString("import"), .kind = TK_Import},
+    [21] = {.str = mkString("else"), .kind = TK_Else},
+    [24] = {.str = mkString("break"), .kind = TK_Break},
+    [28] = {.str = mkString("func"), .kind = TK_Func},
+    [29] = {.str = mkString("="), .kind = TK_Equals},
+    [30] = {.str = mkString("loop"), .kind = TK_Loop},
+    [31] = {.str = mkString("operator"), .kind = TK_Operator},
 #undef mkString
 };
 
-static bool lexer_immediates(struct Lexer* lexer, struct String input) {
-    if (lexer->rest.len == 0) return false;
-    for (size_t i = 0; i < sizeof(immediates)/sizeof(immediates[0]); i++) {
-        if (!strings_prefix_of(input, immediates[i].str)) continue;
-        lexer->token.spelling = input;
-        lexer->token.spelling.len = immediates[i].str.len;
-        lexer->token.kind = immediates[i].kind;
-        lexer->token.number = 0;
-        lexer->rest = strings_drop(input, immediates[i].str.len);
-        return true;
-    }
-    return false;
+static size_t lexer_hash(struct String word) {
+    uint8_t first = word.str[0];
+    uint8_t second = word.str[word.len > 1];
+    return (first + 22 * second + 2 * word.len) & 31;
 }
 
-static bool lexer_starts_word_break(struct String input) {
-    if (input.len == 0) return true;
-    return lexer_is_word_break(input.str[0]);
-}
-
-static bool lexer_keywords(struct Lexer* lexer, struct String input) {
-    const struct SpellingEntry table[] = {
-#define mkString(s) {.str = s, .len = sizeof(s) - 1}
-        {.str = mkString("func"), .kind = TK_Func},
-        {.str = mkString("return"), .kind = TK_Return},
-        {.str = mkString("loop"), .kind = TK_Loop},
-        {.str = mkString("break"), .kind = TK_Break},
-        {.str = mkString("if"), .kind = TK_If},
-        {.str = mkString("else"), .kind = TK_Else},
-        {.str = mkString("let"), .kind = TK_Let},
-        {.str = mkString("mut"), .kind = TK_Mut},
-        {.str = mkString("type"), .kind = TK_Type},
-        {.str = mkString("as"), .kind = TK_As},
-        {.str = mkString("operator"), .kind = TK_Operator},
-        {.str = mkString("="), .kind = TK_Equals},
-        {.str = mkString("import"), .kind = TK_Import},
-#undef mkString
-    };
-
-    if (lexer->rest.len == 0) return false;
-    for (size_t i = 0; i < sizeof(table)/sizeof(table[0]); i++) {
-        if (!strings_prefix_of(input, table[i].str)) continue;
-        struct String rest = strings_drop(input, table[i].str.len);
-        if (!lexer_starts_word_break(rest)) return false;
-        lexer->token.spelling = input;
-        lexer->token.spelling.len = table[i].str.len;
-        lexer->token.kind = table[i].kind;
-        lexer->token.number = 0;
-        lexer->rest = rest;
-        return true;
+// most runs are short enough that calling out to bytescan
+// costs more than it saves, so it only takes over after this many bytes
+#define LEXER_SHORT_RUN 8
+
+// end of the run of bytes in set starting at from,
+// scan only finds the candidates for its end
+static size_t lexer_run(
+    struct String in, size_t from, unsigned set,
+    size_t (*scan)(const char*, size_t)
+) {
+    size_t short_end = from + LEXER_SHORT_RUN < in.len ? from + LEXER_SHORT_RUN : in.len;
+    while (from < short_end && lexer_in(in.str[from], set)) from++;
+    if (from < short_end) return from;
+    while (from < in.len) {
+        from += scan(in.str + from, in.len - from);
+        if (from == in.len || !lexer_in(in.str[from], set)) break;
+        from++;
     }
-    return false;
+    return from;
 }
 
-static bool lexer_bools(struct Lexer* lexer, struct String input) {
-    const struct SpellingEntry table[] = {
-        {.str = {"true", 4}, .kind = TK_Bool},
-        {.str = {"false", 5}, .kind = TK_Bool},
-    };
-
-    if (lexer->rest.len == 0) return false;
-    for (size_t i = 0; i < sizeof(table)/sizeof(table[0]); i++) {
-        if (!strings_prefix_of(input, table[i].str)) continue;
-        struct String rest = strings_drop(input, table[i].str.len);
-        if (!lexer_starts_word_break(rest)) return false;
-        lexer->token.spelling = input;
-        lexer->token.spelling.len = table[i].str.len;
-        lexer->token.kind = table[i].kind;
-        lexer->token.number = 0;
-        lexer->rest = strings_drop(input, table[i].str.len);
-        return true;
-    }
-    return false;
+// a keyword or bool if the word up to the next break is one,
+// a name running on through digits otherwise
+static enum Tokenkind lexer_word(struct String in, size_t *len) {
+    struct String word = {in.str, lexer_run(in, 0, LS_Word, bytescan_word)};
+    *len = word.len;
+    const struct SpellingEntry *entry = &keywords[lexer_hash(word)];
+    if (strings_equal(word, entry->str)) return entry->kind;
+    *len = lexer_run(in, *len, LS_Name, bytescan_word);
+    return TK_Name;
 }
 
-static bool lexer_string(struct Lexer *lexer, struct String in) {
-    size_t len = 0;
-    bool escaped = true;
-    bool loop = true;
-    if (in.str[0] != '"') return false;
-    while (loop && len < in.len) {
-        switch (in.str[len]) {
-        case '\\':
+// runs up to and including the closing quote, or a newline
+static size_t lexer_string(struct String in) {
+    // past the opening quote, which can't be escaped
+    size_t len = 1;
+    bool escaped = false;
+    while (len < in.len) {
+        size_t next = len + bytescan_string(in.str + len, in.len - len);
+        if (next > len) escaped = false;
+        len = next;
+        if (len == in.len) break;
+        char c = in.str[len++];
+        if (c == '\\') {
             escaped = !escaped;
+        } else if (c == '\n' || !escaped) {
             break;
-        case '\n':
-            loop = false;
-            break;
-        case '"':
-            if (!escaped)
-                loop = false;
+        } else {
             escaped = false;
-            break;
-        default:
-            escaped = false;
-            break;
         }
-        len++;
     }
-
-    lexer->token.spelling = in;
-    lexer->token.spelling.len = len;
-    lexer->token.kind = TK_String;
-    lexer->token.number = 0;
-    lexer->rest = strings_drop(in, len);
-    return true;
-}
-
-static bool lexer_number(struct Lexer* lexer, struct String in) {
-    size_t len = 0;
-    while (len < in.len && strings_ascii_digit(in.str[len])) len++;
-    if (len == 0) return false;
-    lexer->token.spelling = in;
-    lexer->token.spelling.len = len;
-    lexer->token.kind = TK_Number;
-    lexer->token.number = atoi(lexer->token.spelling.str);
-    lexer->rest = strings_drop(in, len);
-    return true;
+    return len;
 }
 
-static bool lexer_name(struct Lexer* lexer, struct String in) {
-    size_t len = 0;
-    while (len < in.len && (!lexer_is_word_break(in.str[len]) || strings_ascii_digit(in.str[len]))) len++;
-    if (len == 0) return false;
-    lexer->token.spelling = in;
-    lexer->token.spelling.len = len;
-    lexer->token.kind = TK_Name;
-    lexer->token.number = 0;
-    lexer->rest = strings_drop(in, len);
-    return true;
-}
+struct Token Lexer_next(struct Lexer* lexer) {
+    struct String in = lexer->rest;
+    if (in.len == 0) return (struct Token){0};
+    size_t len = lexer_run(in, 0, 1u << LC_Space, bytescan_space);
+    in = strings_drop(in, len);
+    lexer->rest = in;
+    if (in.len == 0) return (struct Token){0};
 
-static struct String lexer_strip_whitespace(struct String in) {
-    size_t len = 0;
-    while (len < in.len && strings_ascii_whitespace(in.str[len]))
-        len++;
-    return strings_drop(in, len);
-}
+    enum Tokenkind kind;
+    struct Literal number = {0};
+    len = 1;
+    switch (lexer_class(in.str[0])) {
+    case LC_Nul:
+        return (struct Token){0};
+    case LC_Slash:
+        if (in.len > 1 && in.str[1] == '/') {
+            len += bytescan_newline(in.str + len, in.len - len);
+            kind = TK_Comment;
+            break;
+        }
+        kind = TK_Slash;
+        break;
+    case LC_Immediate:
+        kind = immediates[(uint8_t) in.str[0]];
+        break;
+    case LC_Quote:
+        len = lexer_string(in);
+        kind = TK_String;
+        break;
+    case LC_Digit:
+        len = Literal_lex(in, &number);
+        kind = TK_Number;
+        break;
+    case LC_Dot:
+        if (in.len >= 3 && in.str[1] == '.' && in.str[2] == '.') {
+            len = 3;
+            kind = TK_Ellipsis;
+            break;
+        }
+        kind = lexer_word(in, &len);
+        break;
+    default:
+        kind = lexer_word(in, &len);
+        break;
+    }
 
-static bool lexer_comment(struct Lexer *lexer, struct String in) {
-    size_t len = 0;
-    if (!strings_prefix_of(in, (struct String){"//", 2})) return false;
-    while (len < in.len && in.str[len] != '\n')
-        len++;
-    lexer->token.kind = TK_Comment;
-    lexer->token.spelling = in;
-    lexer->token.number = 0;
+    lexer->token = (struct Token){
+        .kind = kind,
+        .spelling = {in.str, len},
+        .number = number,
+    };
     lexer->rest = strings_drop(in, len);
-    return true;
-}
-
-static bool lexer_is_word_break(char input) {
-    if (input == '\0' || input == '"' || strings_ascii_digit(input) ||
-        strings_ascii_whitespace(input))
-        return true;
-    for (unsigned int i = 0; i < sizeof(immediates)/sizeof(immediates[0]); i++) {
-        if (strings_prefix_of((struct String){&input, 1}, immediates[i].str)) return true;
-    }
-    return false;
+    return lexer->token;
 }
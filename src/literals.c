@@ -0,0 +1,95 @@
+#include "./literals.h"
+#include <assert.h>
+#include <limits.h>
+
+// the value of c as a digit, or something past every base if it's none
+static unsigned literal_digit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    c |= 0x20;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return UINT_MAX;
+}
+
+size_t Literal_lex(struct String in, struct Literal* out) {
+    unsigned base = 10;
+    size_t len = 0;
+    // only a prefix if a digit of its base follows, so 0x alone is 0 and x
+    if (in.len > 2 && in.str[0] == '0') {
+        char prefix = in.str[1] | 0x20;
+        if (prefix == 'x' && literal_digit(in.str[2]) < 16) base = 16, len = 2;
+        if (prefix == 'b' && literal_digit(in.str[2]) < 2) base = 2, len = 2;
+    }
+
+    // in 32 bit limbs, so a limb times the base plus a carry fits in a word
+    uint32_t limbs[2 * Literal_words] = {0};
+    bool saturated = false;
+    for (; len < in.len; len++) {
+        // only between digits, so 1_ is 1 and _ and 1_foo is 1 and _foo
+        if (in.str[len] == '_' && len + 1 < in.len && literal_digit(in.str[len + 1]) < base) {
+            continue;
+        }
+        unsigned digit = literal_digit(in.str[len]);
+        if (digit >= base) break;
+        uint64_t carry = digit;
+        for (size_t i = 0; i < 2 * Literal_words; i++) {
+            uint64_t limb = (uint64_t) limbs[i] * base + carry;
+            limbs[i] = (uint32_t) limb;
+            carry = limb >> 32;
+        }
+        if (carry) saturated = true;
+    }
+
+    for (size_t i = 0; i < Literal_words; i++) {
+        out->words[i] = saturated
+            ? UINT64_MAX
+            : limbs[2 * i] | (uint64_t) limbs[2 * i + 1] << 32;
+    }
+    return len;
+}
+
+bool Literal_fits(struct Literal this, unsigned bits) {
+    for (size_t i = 0; i < Literal_words; i++) {
+        unsigned here = bits < 64 ? bits : 64;
+        if (here < 64 && this.words[i] >> here) return false;
+        bits -= here;
+    }
+    return true;
+}
+
+int Literal_int(struct Literal this) {
+    return Literal_fits(this, sizeof(int) * CHAR_BIT - 1) ? (int) this.words[0] : INT_MAX;
+}
+
+struct Literals Literals_init(struct serene_Allocator alloc) {
+    struct Literals out = {.alloc = alloc};
+    pthread_mutex_init(&out.lock, NULL);
+    return out;
+}
+
+uint32_t Literals_push(struct Literals* this, struct Literal literal) {
+    pthread_mutex_lock(&this->lock);
+    if (this->len >= this->cap) {
+        uint32_t cap = this->cap ? this->cap * 2 : 64;
+        struct Literal* buf = this->buf
+            ? serene_nresize(this->alloc, this->buf, this->cap, cap)
+            : serene_nalloc(this->alloc, cap, struct Literal);
+        assert(buf && "OOM");
+        this->buf = buf;
+        this->cap = cap;
+    }
+    this->buf[this->len] = literal;
+    uint32_t idx = this->len++;
+    pthread_mutex_unlock(&this->lock);
+    return idx;
+}
+
+struct Literal Literals_get(const struct Literals* this, uint32_t idx) {
+    assert(idx < this->len && "no such literal");
+    return this->buf[idx];
+}
+
+void Literals_deinit(struct Literals* this) {
+    if (this->buf) serene_nfree(this->alloc, this->cap, this->buf);
+    pthread_mutex_destroy(&this->lock);
+    *this = (struct Literals){0};
+}
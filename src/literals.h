@@ -0,0 +1,46 @@
+#ifndef LITERALS_H
+#define LITERALS_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "strings.h"
+#include "serene.h"
+
+// the value of a number literal, least significant word first,
+// laid out the way LLVMConstIntOfArbitraryPrecision takes it
+#define Literal_words 2
+
+struct Literal {
+    uint64_t words[Literal_words];
+};
+
+// the length of the number at the start of in, which has to start
+// with a digit, and its value in out; takes 0x and 0b prefixes
+// and underscores between digits, saturates past 128 bits
+size_t Literal_lex(struct String in, struct Literal* out);
+// whether the value fits in an unsigned integer of that many bits
+bool Literal_fits(struct Literal, unsigned bits);
+// clamped to INT_MAX, for counts and precedences
+int Literal_int(struct Literal);
+
+// number literals referenced by index from the syntax trees,
+// so they're parsed once and carried through to codegen;
+// modules parsed on different threads push to it at once,
+// so then alloc has to be safe to share as well
+struct Literals {
+    pthread_mutex_t lock;
+    struct Literal* buf;
+    uint32_t len;
+    uint32_t cap;
+    struct serene_Allocator alloc;
+};
+
+struct Literals Literals_init(struct serene_Allocator);
+uint32_t Literals_push(struct Literals*, struct Literal);
+struct Literal Literals_get(const struct Literals*, uint32_t);
+void Literals_deinit(struct Literals*);
+
+#endif
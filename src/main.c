@@ -3,6 +3,9 @@
 #include <stdlib.h>
 #include <string.h>
 #include <libgen.h>
+#include <stdbool.h>
+#include <sys/resource.h>
+#include <time.h>
 
 #include <llvm-c/Core.h>
 #include <llvm-c/Target.h>
@@ -18,65 +21,247 @@
 #include "./typer.h"
 #include "opscan.h"
 #include "preimport.h"
+#include "sched.h"
 #include "serene.h"
 
-void source_print(void* _string) {
-    struct String* string = _string;
-    printf("String{ %p, len: %zu }", string->str, string->len);
+// more threads than this won't help, and jobs sizes arrays on the stack
+#define JOBS_MAX 256
+
+void file_print(void* _file) {
+    struct MTreeFile* file = _file;
+    printf("File{ %s }", file->path);
 }
 
-int main(int argc, char** argv) {
-    struct serene_Trea
-        alloc = serene_Trea_init(serene_Libc_dyn()),
-        module_alloc = serene_Trea_sub(&alloc),
-        tst_alloc = serene_Trea_sub(&alloc),
-        strings_alloc = serene_Trea_sub(&alloc);
+struct Phase {
+    const char* name;
+    double ms;
+    size_t requested;
+    size_t live;
+    size_t peak;
+};
+
+struct Report {
+    struct serene_Tracer* tracer;
+    struct {
+        const char* name;
+        struct serene_Stats stats;
+    } allocs[5];
+    struct Phase phases[8];
+    int phase_count;
+    double start;
+};
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+static void Report_phase(struct Report* this, const char* name) {
+    size_t requested = 0;
+    for (size_t i = 0; i < sizeof(this->allocs) / sizeof(this->allocs[0]); i++) {
+        requested += this->allocs[i].stats.requested;
+    }
+    for (int i = 0; i < this->phase_count; i++) {
+        requested -= this->phases[i].requested;
+    }
+    double now = now_ms();
+    this->phases[this->phase_count++] = (struct Phase) {
+        .name = name,
+        .ms = now - this->start,
+        .requested = requested,
+        .live = this->tracer->stats.live,
+        .peak = this->tracer->stats.peak,
+    };
+    this->start = now;
+}
+
+// splits ms off the end of the last phase into one of its own before it
+static void Report_carve(struct Report* this, const char* name, double ms) {
+    struct Phase last = this->phases[this->phase_count - 1];
+    this->phases[this->phase_count - 1] = (struct Phase) {
+        .name = name,
+        .ms = ms,
+        .live = last.live,
+        .peak = last.peak,
+    };
+    last.ms -= ms;
+    this->phases[this->phase_count++] = last;
+}
 
-    if (argc != 2) {
+static void Report_print(struct Report* this) {
+    printf("\n--- memory: ---\n");
+    printf("%-10s %10s %12s %12s %12s\n", "phase", "ms", "requested", "live", "peak");
+    double front = 0;
+    for (int i = 0; i < this->phase_count; i++) {
+        struct Phase p = this->phases[i];
+        printf(
+            "%-10s %10.2f %12zu %12zu %12zu\n",
+            p.name, p.ms, p.requested, p.live, p.peak
+        );
+        // everything before lowering to llvm
+        if (strcmp(p.name, "lower") != 0) front += p.ms;
+    }
+    printf("%-10s %10.2f\n", "front-end", front);
+    printf(
+        "\n%-10s %12s %12s %8s %12s %12s\n",
+        "allocator", "requested", "padding", "blocks", "live", "peak"
+    );
+    for (size_t i = 0; i < sizeof(this->allocs) / sizeof(this->allocs[0]); i++) {
+        struct serene_Stats s = this->allocs[i].stats;
+        printf(
+            "%-10s %12zu %12zu %8zu %12zu %12zu\n",
+            this->allocs[i].name, s.requested, s.padding, s.blocks, s.live, s.peak
+        );
+    }
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        printf("\npeak rss: %ld KiB\n", usage.ru_maxrss);
+    }
+}
+
+int main(int argc, char** argv) {
+    bool stats = false;
+    bool use_mmap = false;
+    bool stream = false;
+    unsigned jobs = 1;
+    const char* intern_cache = NULL;
+    char* path = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--stats") == 0) {
+            stats = true;
+        } else if (strcmp(argv[i], "--mmap") == 0) {
+            use_mmap = true;
+        } else if (strcmp(argv[i], "--stream") == 0) {
+            stream = true;
+        } else if (strncmp(argv[i], "--jobs=", 7) == 0) {
+            char* end;
+            long count = strtol(argv[i] + 7, &end, 10);
+            if (end == argv[i] + 7 || *end || count < 1) {
+                printf("--jobs needs a positive count!\n");
+                return 1;
+            }
+            jobs = count < JOBS_MAX ? count : JOBS_MAX;
+        } else if (strncmp(argv[i], "--intern-cache=", 15) == 0) {
+            intern_cache = argv[i] + 15;
+        } else if (strncmp(argv[i], "--", 2) == 0) {
+            printf("Unknown option '%s'!\n", argv[i]);
+            return 1;
+        } else if (path) {
+            printf("Please provide a single filename!\n");
+            return 1;
+        } else {
+            path = argv[i];
+        }
+    }
+    if (!path) {
         printf("Please provide a single filename!\n");
         return 1;
     }
 
+    // reserves address space only, pages get committed as they're used
+    struct serene_Mmap mmap_backing = serene_Mmap_init((size_t) 1 << 30);
+    struct serene_Tracer tracer = {
+        .backing = use_mmap ? serene_Mmap_dyn(&mmap_backing) : serene_Libc_dyn(),
+    };
+    struct Report report = {
+        .tracer = &tracer,
+        .allocs = {
+            {.name = "module"},
+            {.name = "tst"},
+            {.name = "strings"},
+            {.name = "typer"},
+            {.name = "lower"},
+        },
+        .start = now_ms(),
+    };
+    struct serene_Trea
+        alloc = serene_Trea_init(serene_Tracer_dyn(&tracer)),
+        // tokens and syntax trees of every module end up in here
+        module_alloc = serene_Trea_sub_sized(&alloc, 64 * 1024),
+        tst_alloc = serene_Trea_sub(&alloc),
+        strings_alloc = serene_Trea_sub(&alloc);
+    serene_Trea_track(&module_alloc, &report.allocs[0].stats);
+    serene_Trea_track(&tst_alloc, &report.allocs[1].stats);
+    serene_Trea_track(&strings_alloc, &report.allocs[2].stats);
+
     struct String main_mod;
     {
-        int len = strlen(argv[1]);
-        if (len < 5 || strcmp(&argv[1][len - 5], ".tara") != 0) {
+        int len = strlen(path);
+        if (len < 5 || strcmp(&path[len - 5], ".tara") != 0) {
             printf("Please provide a file with a '.tara' extension!\n");
             return 1;
         }
         char* str = serene_trenalloc(&alloc, len - 4, char);
         assert(str && "OOM");
-        snprintf(str, len - 4, "%s", argv[1]);
+        snprintf(str, len - 4, "%s", path);
         main_mod.str = basename(str);
         main_mod.len = strlen(main_mod.str);
     }
-    char* dir_path = dirname(argv[1]);
+    char* dir_path = dirname(path);
     int dir_len = strlen(dir_path);
     struct MTree* mtree = MTree_load(&module_alloc, (struct String){dir_path, dir_len});
     printf("\n--- load time: ---\n");
-    MTree_print(mtree, source_print);
+    MTree_print(mtree, file_print);
+    Report_phase(&report, "load");
 
-    struct Intern intern = Intern_init(strings_alloc);
+    // big modules get lexed on several threads, which all intern
+    struct serene_Locked locked = serene_Locked_init(serene_Tracer_dyn(&tracer));
+    struct Intern intern = jobs > 1
+        ? Intern_init_concurrent(serene_Locked_dyn(&locked), 16)
+        : Intern_init(strings_alloc);
+    // a missing or outdated cache just means starting from scratch
+    if (intern_cache) Intern_load(&intern, intern_cache, &symbols_names[1], SYM_bint_to_ptr);
     struct Symbols symbols = populate_interner(&intern);
-    mtree = scan(&module_alloc, &intern, mtree);
+    // number literals of every module, codegen builds constants out of them;
+    // with jobs modules get parsed on the workers, which all grow it
+    struct Literals literals = Literals_init(
+        jobs > 1 ? serene_Locked_dyn(&locked) : serene_Trea_dyn(&module_alloc)
+    );
+    double read_ms;
+    mtree = scan(
+        &module_alloc, serene_Locked_dyn(&locked), &intern, mtree, main_mod,
+        stream, jobs, &report.allocs[0].stats, &read_ms
+    );
+    Report_phase(&report, "scan");
+    Report_carve(&report, "read", read_ms);
     printf("\n--- scan time: ---\n");
     MTree_print(mtree, PIData_print);
 
-    mtree = preimport(&module_alloc, mtree);
-    printf("\n--- preimport time: ---\n");
-    MTree_print(mtree, PIData_print);
+    // with jobs every module goes through the next three phases on its own
+    // as soon as its imports have, so the dumps in between don't exist
+    struct Schedule sched = {0};
+    if (jobs > 1) {
+        mtree = schedule(
+            &sched, &module_alloc, serene_Locked_dyn(&locked), &symbols, &literals,
+            mtree, jobs, &report.allocs[0].stats, &report.allocs[3].stats
+        );
+        Report_phase(&report, "modules");
+        printf("\n--- schedule time: %zu modules in %zu waves ---\n", sched.len, sched.waves);
+    } else {
+        mtree = preimport(&module_alloc, mtree);
+        Report_phase(&report, "preimport");
+        printf("\n--- preimport time: ---\n");
+        MTree_print(mtree, PPData_print);
 
-    mtree = parse(&module_alloc, &symbols, mtree);
-    printf("\n--- parse time: ---\n");
-    MTree_print(mtree, PTData_print);
+        mtree = parse(&module_alloc, &symbols, &literals, mtree);
+        Report_phase(&report, "parse");
+        printf("\n--- parse time: ---\n");
+        MTree_print(mtree, PTData_print);
 
-    typecheck(mtree);
+        typecheck(mtree, &report.allocs[3].stats);
+        Report_phase(&report, "typecheck");
+    }
     printf("\n--- typecheck time: ---\n");
     MTree_print(mtree, PTData_print);
 
     struct Tst tst = convert_ast(&tst_alloc, MTree_index(mtree, main_mod)->data);
+    Report_phase(&report, "convert");
 
-    LLVMModuleRef mod = lower(&tst, serene_Trea_sub(&tst_alloc));
+    struct serene_Trea lower_alloc = serene_Trea_sub(&tst_alloc);
+    serene_Trea_track(&lower_alloc, &report.allocs[4].stats);
+    LLVMModuleRef mod = lower(&tst, &literals, lower_alloc);
+    Report_phase(&report, "lower");
 
     printf("\n--- lolvm time: ---\n");
     LLVMDumpModule(mod);
@@ -117,7 +302,16 @@ int main(int argc, char** argv) {
         // unused
     }
 
+    if (intern_cache && !Intern_save(&intern, intern_cache)) {
+        printf("Couldn't write the intern cache to '%s'!\n", intern_cache);
+    }
+    if (stats) Report_print(&report);
+    Literals_deinit(&literals);
+    Schedule_deinit(&sched);
+    Intern_deinit(&intern);
+    serene_Locked_deinit(&locked);
     serene_Trea_deinit(alloc);
+    serene_Mmap_deinit(&mmap_backing);
     printf("\n");
     return 0;
 }
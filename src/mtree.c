@@ -8,6 +8,7 @@
 #include <string.h>
 #include <stdio.h>
 #include <sys/mman.h>
+#include <sys/syscall.h>
 #include <unistd.h>
 #include <sys/stat.h>
 #include <assert.h>
@@ -47,89 +48,172 @@ void MTree_map_whole(
     f(ctx, this);
 }
 
+// the slot holding name, or the empty one it would go in
+static uint32_t* index_slot(const struct MTree* this, struct String name) {
+    size_t mask = this->index_cap - 1;
+    for (size_t at = strings_hash(name) & mask;; at = (at + 1) & mask) {
+        uint32_t* slot = &this->index[at];
+        if (!*slot || strings_equal(this->subs[*slot - 1].name, name)) return slot;
+    }
+}
+
 struct MTree* MTree_index(struct MTree* this, struct String idx) {
-    for (size_t i = 0; i < this->subs_count; i++) {
-        if (strings_equal(idx, this->subs[i].name))
-            return &this->subs[i];
+    if (!this->index_cap) return NULL;
+    uint32_t slot = *index_slot(this, idx);
+    return slot ? &this->subs[slot - 1] : NULL;
+}
+
+bool MTreeFile_load(struct MTreeFile* this, struct serene_Trea* arena) {
+    int fd = open(this->path, O_RDONLY);
+    if (fd == -1) return false;
+    struct stat stat;
+    if (fstat(fd, &stat) != 0) {
+        close(fd);
+        return false;
+    }
+    size_t size = stat.st_size;
+    this->mapped = size > MTreeFile_small;
+    if (this->mapped) {
+        // read front to back exactly once, so fault it all in up front
+        char* str = mmap(NULL, size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+        close(fd);
+        if (str == MAP_FAILED) return false;
+        madvise(str, size, MADV_SEQUENTIAL);
+        this->source = (struct String){str, size};
+        return true;
+    }
+    char* str = serene_trenalloc(arena, size + 1, char);
+    assert(str && "OOM");
+    size_t len = 0;
+    while (len < size) {
+        ssize_t got = pread(fd, str + len, size - len, len);
+        if (got <= 0) break;
+        len += got;
     }
-    return NULL;
+    close(fd);
+    this->source = (struct String){str, len};
+    return true;
 }
 
+void MTreeFile_unload(struct MTreeFile* this) {
+    // yes gcc we know source.str is const
+    if (this->mapped) munmap((char*)this->source.str, this->source.len);
+    this->source = (struct String){0};
+    this->mapped = false;
+}
 
-static void from_file(
-    struct MTree* out,
-    struct serene_Trea* alloc,
-    int fd,
-    struct stat* stat
-) {
-    struct String* data = serene_trealloc(alloc, struct String);
-    assert(data && "OOM"), ZERO(*data);
-    data->str = mmap(NULL, stat->st_size, PROT_READ, MAP_PRIVATE, fd, 0);
-    data->len = stat->st_size;
-    out->data = data;
+// what getdents64 fills its buffer with
+struct Dirent64 {
+    uint64_t d_ino;
+    int64_t d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[];
+};
+
+struct DirBuf {
+    char* buf;
+    size_t len;
+    size_t cap;
+};
+
+// the entries of the whole directory, in one go so it's
+// only walked once, mostly with a single getdents64
+static struct DirBuf read_dir(int dir_fd) {
+    struct serene_Allocator libc = serene_Libc_dyn();
+    struct DirBuf out = {.cap = 32 * 1024};
+    out.buf = serene_nalloc(libc, out.cap, char);
+    assert(out.buf && "OOM");
+    while (true) {
+        // room for at least one entry, or getdents64 fails
+        if (out.cap - out.len < 1024) {
+            char* buf = serene_nresize(libc, out.buf, out.cap, out.cap * 2);
+            assert(buf && "OOM");
+            out.buf = buf;
+            out.cap *= 2;
+        }
+        long got = syscall(SYS_getdents64, dir_fd, out.buf + out.len, out.cap - out.len);
+        assert(got >= 0);
+        if (got == 0) break;
+        out.len += got;
+    }
+    return out;
 }
 
-static int count_entries(DIR* dir) {
-    int count = 0;
-    for (
-        struct dirent* entry = readdir(dir);
-        entry;
-        entry = readdir(dir)
-    ) count++;
-    rewinddir(dir);
-    return count;
+// d_type is enough most of the time, only links
+// and filesystems that leave it out need a stat
+static bool is_dir_entry(int dir_fd, struct Dirent64* entry) {
+    if (entry->d_type == DT_DIR) return true;
+    if (entry->d_type != DT_UNKNOWN && entry->d_type != DT_LNK) return false;
+    struct stat stat;
+    return fstatat(dir_fd, entry->d_name, &stat, 0) == 0 && S_ISDIR(stat.st_mode);
 }
 
-static struct Row {
-    struct MTree* subs;
-    size_t subs_count;
-} row_from_dir(
+static char* join_path(struct serene_Trea* alloc, const char* dir, const char* name) {
+    int len = strlen(dir) + 1 + strlen(name);
+    char* out = serene_trenalloc(alloc, len + 1, char);
+    assert(out && "OOM");
+    snprintf(out, len + 1, "%s/%s", dir, name);
+    return out;
+}
+
+#define dir_iter(NAME, DIR)                                                    \
+    struct Dirent64* NAME = (struct Dirent64*) (DIR).buf;                      \
+    (char*) NAME < (DIR).buf + (DIR).len;                                      \
+    NAME = (struct Dirent64*) ((char*) NAME + NAME->d_reclen)
+
+// fills in the subs of out, a directory and a module
+// of the same name end up in the same node; closes dir_fd
+static void row_from_dir(
+    struct MTree* out,
     struct serene_Trea* alloc,
-    int dir_fd
+    int dir_fd,
+    const char* dir_path
 ) {
-    DIR* dir = fdopendir(dir_fd);
-    int alloc_size = count_entries(dir);
-    struct MTree* subs = serene_trenalloc(alloc, alloc_size, struct MTree);
-    assert(subs && "OOM");
-    size_t subs_count = 0;
-    for (struct dirent* entry = readdir(dir); entry; entry = readdir(dir)) {
+    struct DirBuf dir = read_dir(dir_fd);
+    size_t alloc_size = 0;
+    for (dir_iter(entry, dir)) alloc_size++;
+    out->subs = serene_trenalloc(alloc, alloc_size, struct MTree);
+    // at most half full, so probes stay short
+    out->index_cap = 8;
+    while (out->index_cap < 2 * alloc_size) out->index_cap *= 2;
+    out->index = serene_trenalloc(alloc, out->index_cap, uint32_t);
+    assert(out->subs && out->index && "OOM");
+    memset(out->index, 0, out->index_cap * sizeof(*out->index));
+    out->subs_count = 0;
+    for (dir_iter(entry, dir)) {
         if (entry->d_name[0] == '.') continue;
-        struct MTree* slot = &subs[subs_count];
-        ZERO(*slot);
-        int entry_fd = openat(dir_fd, entry->d_name, O_RDONLY);
-        struct stat stat;
-        assert(fstat(entry_fd, &stat) == 0);
-        bool is_dir = S_ISDIR(stat.st_mode);
+        bool is_dir = is_dir_entry(dir_fd, entry);
         int len = strlen(entry->d_name);
-        bool ext = is_dir || 0 == strcmp(entry->d_name + len - 5, ".tara");
-        if (!ext) {
-            close(entry_fd);
-            continue;
-        }
+        bool ext = is_dir || (len > 5 && 0 == strcmp(entry->d_name + len - 5, ".tara"));
+        if (!ext) continue;
         if (!is_dir) { len -= 5; }
-        struct String search = {entry->d_name, len};
-        for (size_t j = 0; j < subs_count; j++) {
-            if (!strings_equal(subs[j].name, search)) continue;
-            slot = &subs[j];
-            subs_count--;
-            goto after;
+        uint32_t* at = index_slot(out, (struct String){entry->d_name, len});
+        struct MTree* slot;
+        if (*at) {
+            slot = &out->subs[*at - 1];
+        } else {
+            slot = &out->subs[out->subs_count++];
+            ZERO(*slot);
+            char* str = serene_trenalloc(alloc, len + 1, char);
+            assert(str && "OOM");
+            snprintf(str, len + 1, "%s", entry->d_name);
+            slot->name = (struct String){str, len};
+            *at = out->subs_count;
         }
-        char* str = serene_trenalloc(alloc, len + 1, char);
-        assert(str && "OOM");
-        snprintf(str, len + 1, "%s", entry->d_name);
-        slot->name = (struct String){str, len};
-    after:
         if (is_dir) {
-            struct Row row = row_from_dir(alloc, entry_fd);
-            slot->subs = row.subs;
-            slot->subs_count = row.subs_count;
+            int entry_fd = openat(dir_fd, entry->d_name, O_RDONLY | O_DIRECTORY);
+            assert(entry_fd != -1);
+            row_from_dir(slot, alloc, entry_fd, join_path(alloc, dir_path, entry->d_name));
         } else {
-            from_file(slot, alloc, entry_fd, &stat);
+            struct MTreeFile* file = serene_trealloc(alloc, struct MTreeFile);
+            assert(file && "OOM"), ZERO(*file);
+            file->path = join_path(alloc, dir_path, entry->d_name);
+            slot->data = file;
         }
-        close(entry_fd);
-        subs_count++;
     }
-    return (struct Row){subs, subs_count};
+    serene_nfree(serene_Libc_dyn(), dir.cap, dir.buf);
+    close(dir_fd);
 }
 
 struct MTree* MTree_load(
@@ -141,10 +225,6 @@ struct MTree* MTree_load(
     out->name = dir_path;
     int dir_fd = open(dir_path.str, O_RDONLY | O_DIRECTORY);
     assert(dir_fd != -1);
-    struct Row row = row_from_dir(alloc, dir_fd);
-    out->subs = row.subs;
-    out->subs_count = row.subs_count;
-    close(dir_fd);
+    row_from_dir(out, alloc, dir_fd, dir_path.str);
     return out;
 }
-
@@ -3,11 +3,18 @@
 
 #include "strings.h"
 
+#include <stdbool.h>
+#include <stdint.h>
+
 struct MTree {
     struct MTree* subs;
     size_t subs_count;
     struct String name;
     void* data;
+    // open addressing over the names of subs, a power of two
+    // at least twice subs_count; 0 is empty and i + 1 is subs[i]
+    uint32_t* index;
+    size_t index_cap;
 };
 
 // cleanup is needed, since MTree doesn't know
@@ -27,8 +34,28 @@ void MTree_map_whole(
 
 void MTree_print(struct MTree*, void (*print_data)(void*));
 
+// the sub with that name, or NULL
 struct MTree* MTree_index(struct MTree*, struct String);
 
+// what MTree_load leaves in the nodes of modules, they're only
+// opened once something turns out to import them
+struct MTreeFile {
+    const char* path;
+    // filled in by MTreeFile_load, whoever loads it unloads it
+    struct String source;
+    bool mapped;
+};
+
+// modules up to this big get read into the arena, each mapping would
+// cost a page and a handful of syscalls; bigger ones get mapped
+#define MTreeFile_small (16 * 1024)
+
+bool MTreeFile_load(struct MTreeFile*, struct serene_Trea* arena);
+// unmaps it if it was mapped, the arena keeps the rest
+void MTreeFile_unload(struct MTreeFile*);
+
+// only indexes the names of directories and modules,
+// no module gets opened
 struct MTree* MTree_load(
     struct serene_Trea*,
     struct String dir_path
@@ -8,6 +8,7 @@ struct Opdecl {
     int lbp;
     int rbp;
     struct String token;
+    uint32_t sym;
 };
 
 #endif
@@ -1,5 +1,5 @@
 #include "opdeclvec.h"
-#include <stdlib.h>
+#include <string.h>
 
 struct Opdecl *Opdecls_at(struct Opdecls *this, size_t idx) {
     if (!this->buf) return NULL;
@@ -7,26 +7,36 @@ struct Opdecl *Opdecls_at(struct Opdecls *this, size_t idx) {
     return this->buf + idx;
 }
 
-bool Opdecls_init(struct Opdecls *this) {
-    if (this->buf) return false;
-    struct Opdecl *buf = malloc(4 * sizeof(struct Opdecl));
+static bool Opdecls_realloc(struct Opdecls *this, size_t cap) {
+    if (!this->alloc.alloc) this->alloc = serene_Libc_dyn();
+    struct Opdecl *buf;
+    if (this->buf) {
+        buf = serene_nresize(this->alloc, this->buf, this->cap, cap);
+    } else {
+        buf = serene_nalloc(this->alloc, cap, struct Opdecl);
+    }
     if (!buf) return false;
     this->buf = buf;
-    this->cap = 4;
-    this->len = 0;
+    this->cap = cap;
     return true;
 }
 
+bool Opdecls_init(struct Opdecls *this) {
+    if (this->buf) return false;
+    this->len = 0;
+    return Opdecls_realloc(this, 4);
+}
+
 bool Opdecls_grow(struct Opdecls *this) {
     if (!this->buf) return Opdecls_init(this);
-    struct Opdecl *buf = malloc(2 * this->cap * sizeof(struct Opdecl));
-    if (!buf) return false;
-    for (size_t i = 0; i < this->len; i++)
-        buf[i] = this->buf[i];
-    free(this->buf);
-    this->cap *= 2;
-    this->buf = buf;
-    return true;
+    return Opdecls_realloc(this, 2 * this->cap);
+}
+
+bool Opdecls_reserve(struct Opdecls *this, size_t n) {
+    if (this->buf && Opdecls_space(this) >= n) return true;
+    size_t cap = this->cap ? this->cap : 4;
+    while (cap - this->len < n) cap *= 2;
+    return Opdecls_realloc(this, cap);
 }
 
 bool Opdecls_push(struct Opdecls *this, struct Opdecl elem) {
@@ -36,6 +46,16 @@ bool Opdecls_push(struct Opdecls *this, struct Opdecl elem) {
     return true;
 }
 
+bool Opdecls_extend(
+    struct Opdecls *this, const struct Opdecl *elems, size_t n
+) {
+    if (n == 0) return true;
+    if (!Opdecls_reserve(this, n)) return false;
+    memcpy(this->buf + this->len, elems, n * sizeof(struct Opdecl));
+    this->len += n;
+    return true;
+}
+
 struct Opdecl *Opdecls_first(struct Opdecls *this) {
     if (this->len == 0) return NULL;
     return this->buf;
@@ -54,7 +74,7 @@ struct Opdecl *Opdecls_emplace(struct Opdecls *this) {
 }
 
 void Opdecls_deinit(struct Opdecls *this) {
-    free(this->buf);
+    if (this->buf) serene_nfree(this->alloc, this->cap, this->buf);
     this->buf = NULL;
     this->len = 0;
     this->cap = 0;
@@ -2,6 +2,7 @@
 #define opdeclvec_H
 
 #include "opdecl.h"
+#include "serene.h"
 #include <stdbool.h>
 #include <stddef.h>
 
@@ -9,12 +10,16 @@ struct Opdecls {
     size_t len;
     size_t cap;
     struct Opdecl *buf;
+    // left zeroed it falls back to libc
+    struct serene_Allocator alloc;
 };
 
 struct Opdecl *Opdecls_at(struct Opdecls *, size_t);
 bool Opdecls_init(struct Opdecls *);
 bool Opdecls_grow(struct Opdecls *);
+bool Opdecls_reserve(struct Opdecls *, size_t);
 bool Opdecls_push(struct Opdecls *, struct Opdecl);
+bool Opdecls_extend(struct Opdecls *, const struct Opdecl *, size_t);
 struct Opdecl *Opdecls_first(struct Opdecls *);
 struct Opdecl *Opdecls_last(struct Opdecls *);
 struct Opdecl *Opdecls_emplace(struct Opdecls *);
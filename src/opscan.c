@@ -1,12 +1,17 @@
 #include "opscan.h"
+#include "bytescan.h"
 #include "lexer.h"
 #include "opdeclvec.h"
-#include "tokenvec.h"
+#include "tokens.h"
 #include "commons.h"
+#include "common_ll.h"
+#include "workers.h"
 
 #include <assert.h>
 #include <stdio.h>
-#include <sys/mman.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
 
 void PIData_print(void* _data) {
     struct PIData* data = _data;
@@ -24,159 +29,588 @@ static struct String cat_strings(
     size_t cum_len
 );
 
-static void* scan_mod(
-    struct serene_Trea* alloc,
-    struct serene_Trea* scratch,
+struct Scanner Scanner_init(
+    struct String source,
     struct Intern* intern,
-    struct String* source
+    struct serene_Trea* scratch,
+    struct serene_Trea* alloc,
+    struct PIData* decls
 ) {
-    struct PIData* data = serene_trealloc(alloc, struct PIData);
-    assert(data && "OOM"), ZERO(*data);
-    struct Lexer lexer = {
-        .rest = *source,
-        .token = {0},
+    struct Scanner out = {
+        .lexer = {.rest = source, .token = {0}},
+        .intern = intern,
+        .scratch = scratch,
+        .alloc = alloc,
+        .decls = decls,
     };
-#define SKIP t = Lexer_next(&lexer)
-#define PUSH(T) assert(Tokenvec_push(&data->toks, T));
-    struct Token t = Lexer_next(&lexer);
-        while (t.kind != TK_EOF) {
-            switch (t.kind) {
-            case TK_String: {
-                struct StringLL* list = serene_trealloc(scratch, struct StringLL);
-                assert(list && "OOM");
-                list->next = NULL;
-                list->current = t.spelling;
-                struct StringLL* last = list;
-                size_t cum_len = t.spelling.len;
-
-                for (SKIP; t.kind == TK_String; SKIP) {
-                    struct StringLL* tmp = serene_trealloc(scratch, struct StringLL);
-                    assert(tmp && "OOM");
-                    *tmp = (typeof(*tmp)){0};
-                    tmp->current = t.spelling;
-                    last->next = tmp;
-                    last = tmp;
-                    cum_len += t.spelling.len;
-                }
+    out.t = Lexer_next(&out.lexer);
+    return out;
+}
 
-                struct String whole = cat_strings(scratch, list, cum_len);
-                struct String spelling = Intern_insert(intern, whole);
-                PUSH(((struct Token){.kind = TK_String, .spelling = spelling, .number = 0}));
-                break;
-            }
-            case TK_Comment: {
-                SKIP;
-                break;
-            }
+#define SKIP this->t = Lexer_next(&this->lexer)
 
-            case TK_Operator: {
-                SKIP;
-                assert(t.kind == TK_OpenParen), SKIP;
-                int lbp;
-                if (t.kind == TK_Number) {
-                    lbp = t.number;
-                } else {
-                    lbp = -1;
-                    assert(t.spelling.str[0] == '_');
-                    assert(t.spelling.len == 1);
-                }
-                SKIP;
-                assert(t.kind == TK_Comma), SKIP;
-                struct String name = Intern_insert(intern, t.spelling);
-                assert(t.kind == TK_Name), SKIP;
-                assert(t.kind == TK_Comma), SKIP;
-                int rbp;
-                if (t.kind == TK_Number) {
-                    rbp = t.number;
-                } else {
-                    rbp = -1;
-                    assert(t.spelling.str[0] == '_');
-                    assert(t.spelling.len == 1);
-                }
-                SKIP;
-                assert(t.kind == TK_CloseParen), SKIP;
+// joins the string literal up next with any right after it
+static struct Token scan_string(struct Scanner* this) {
+    // the pieces and their concatenation are only needed
+    // until the literal is interned
+    struct serene_TreaMark mark = serene_Trea_mark(this->scratch);
+    struct StringLL* list = serene_trealloc(this->scratch, struct StringLL);
+    assert(list && "OOM");
+    list->next = NULL;
+    list->current = this->t.spelling;
+    struct StringLL* last = list;
+    size_t cum_len = this->t.spelling.len;
 
-                assert(Opdecls_push(&data->ops, (struct Opdecl){.token = name, .lbp = lbp, .rbp = rbp}));
-                break;
-            }
+    for (SKIP; this->t.kind == TK_String; SKIP) {
+        struct StringLL* tmp = serene_trealloc(this->scratch, struct StringLL);
+        assert(tmp && "OOM");
+        *tmp = (typeof(*tmp)){0};
+        tmp->current = this->t.spelling;
+        last->next = tmp;
+        last = tmp;
+        cum_len += this->t.spelling.len;
+    }
 
-            case TK_Import: {
-                SKIP;
-
-                assert(t.kind == TK_Name);
-                t.spelling = Intern_insert(intern, t.spelling);
-                struct PIImport head = {
-                    .next = NULL,
-                    .part = t.spelling,
-                };
-                struct PIImport* last = &head;
-                SKIP;
-                while (t.kind == TK_Slash) {
-                    SKIP;
-                    assert(t.kind == TK_Name || t.kind == TK_Ellipsis);
-                    t.spelling = Intern_insert(intern, t.spelling);
-                    struct PIImport* tmp = serene_trealloc(alloc, struct PIImport);
-                    assert(tmp && "OOM"), ZERO(*tmp);
-                    tmp->part = t.spelling;
-                    last->next = tmp;
-                    last = tmp;
-                    if (t.kind == TK_Ellipsis) {
-                        SKIP;
-                        break;
-                    }
-                    SKIP;
-                }
-                struct PIImports* tmp = serene_trealloc(alloc, struct PIImports);
-                assert(tmp && "OOM"), ZERO(*tmp);
-                tmp->next = data->imports;
-                tmp->current = head;
-                data->imports = tmp;
-
-                assert(t.kind == TK_Semicolon);
-                SKIP;
-                break;
-            }
+    struct String whole = cat_strings(this->scratch, list, cum_len);
+    uint32_t sym = Intern_symbol(this->intern, whole);
+    serene_Trea_reset(this->scratch, mark);
+    return (struct Token){
+        .kind = TK_String,
+        .sym = sym,
+        .spelling = Intern_name(this->intern, sym),
+    };
+}
 
-            default: {
-                t.spelling = Intern_insert(intern, t.spelling);
-                PUSH(t);
-                SKIP;
-                break;
-            }
-            }
+// operator(lbp, name, rbp), either binding power may be _
+static void scan_operator(struct Scanner* this) {
+    SKIP;
+    assert(this->t.kind == TK_OpenParen), SKIP;
+    int lbp;
+    if (this->t.kind == TK_Number) {
+        lbp = Literal_int(this->t.number);
+    } else {
+        lbp = -1;
+        assert(this->t.spelling.str[0] == '_');
+        assert(this->t.spelling.len == 1);
+    }
+    SKIP;
+    assert(this->t.kind == TK_Comma), SKIP;
+    struct String name = this->t.spelling;
+    assert(this->t.kind == TK_Name), SKIP;
+    assert(this->t.kind == TK_Comma), SKIP;
+    int rbp;
+    if (this->t.kind == TK_Number) {
+        rbp = Literal_int(this->t.number);
+    } else {
+        rbp = -1;
+        assert(this->t.spelling.str[0] == '_');
+        assert(this->t.spelling.len == 1);
+    }
+    SKIP;
+    assert(this->t.kind == TK_CloseParen), SKIP;
+    if (!this->decls) return;
+
+    uint32_t sym = Intern_symbol(this->intern, name);
+    assert(Opdecls_push(&this->decls->ops, (struct Opdecl){
+        .token = Intern_name(this->intern, sym),
+        .sym = sym,
+        .lbp = lbp,
+        .rbp = rbp,
+    }));
+}
+
+// import a/b/c; or import a/b/...;
+static void scan_import(struct Scanner* this) {
+    bool record = this->decls != NULL;
+    SKIP;
+
+    assert(this->t.kind == TK_Name);
+    struct PIImport head = {
+        .next = NULL,
+        .part = record ? Intern_insert(this->intern, this->t.spelling) : this->t.spelling,
+    };
+    struct PIImport* last = &head;
+    SKIP;
+    while (this->t.kind == TK_Slash) {
+        SKIP;
+        assert(this->t.kind == TK_Name || this->t.kind == TK_Ellipsis);
+        if (record) {
+            struct PIImport* tmp = serene_trealloc(this->alloc, struct PIImport);
+            assert(tmp && "OOM"), ZERO(*tmp);
+            tmp->part = Intern_insert(this->intern, this->t.spelling);
+            last->next = tmp;
+            last = tmp;
+        }
+        if (this->t.kind == TK_Ellipsis) {
+            SKIP;
+            break;
+        }
+        SKIP;
+    }
+    assert(this->t.kind == TK_Semicolon);
+    SKIP;
+    if (!record) return;
+
+    struct PIImports* tmp = serene_trealloc(this->alloc, struct PIImports);
+    assert(tmp && "OOM"), ZERO(*tmp);
+    tmp->next = this->decls->imports;
+    tmp->current = head;
+    this->decls->imports = tmp;
+}
+
+struct Token Scanner_next(struct Scanner* this) {
+    while (true) {
+        switch (this->t.kind) {
+        case TK_EOF:
+            return (struct Token){0};
+        case TK_String:
+            return scan_string(this);
+        case TK_Comment:
+            SKIP;
+            break;
+        case TK_Operator:
+            scan_operator(this);
+            break;
+        case TK_Import:
+            scan_import(this);
+            break;
+        default: {
+            struct Token out = this->t;
+            out.sym = Intern_symbol(this->intern, out.spelling);
+            out.spelling = Intern_name(this->intern, out.sym);
+            SKIP;
+            return out;
+        }
         }
-#undef PUSH
+    }
+}
+
+// only picks out the declarations, everything else
+// is left for the parser to lex again
+static void scan_decls(struct Scanner* this) {
+    while (this->t.kind != TK_EOF) {
+        switch (this->t.kind) {
+        case TK_Operator:
+            scan_operator(this);
+            break;
+        case TK_Import:
+            scan_import(this);
+            break;
+        default:
+            SKIP;
+            break;
+        }
+    }
+}
 #undef SKIP
+
+// a line starting with func is outside of any string, comment or
+// declaration, and no string literal can get joined across it;
+// so lexing from there gives the same tokens as getting there serially
+static size_t scan_restart_after(struct String source, size_t from) {
+    while (from < source.len) {
+        from += bytescan_newline(source.str + from, source.len - from);
+        if (from == source.len) break;
+        size_t line = ++from;
+        while (from < source.len && (source.str[from] == ' ' || source.str[from] == '\t')) from++;
+        if (
+            source.len - from > 4 && strings_prefix_of(
+                (struct String){&source.str[from], 5}, (struct String){"func ", 5}
+            )
+        ) return line;
+    }
+    return source.len;
+}
+
+struct ScanChunk {
+    struct String source;
+    struct Intern* intern;
+    // the chunk's tokens, imports and joined strings live here
+    // until they're merged, the ops on libc
+    struct serene_Trea alloc;
+    struct serene_Stats stats;
+    struct PIData decls;
+    // the lexer stops at a nul, what comes after it is dropped
+    bool stopped;
+};
+
+static void scan_chunk(void* _chunk, unsigned worker) {
+    (void) worker;
+    struct ScanChunk* chunk = _chunk;
+    struct serene_Trea scratch = serene_Trea_sub(&chunk->alloc);
+    struct Scanner scanner = Scanner_init(
+        chunk->source, chunk->intern, &scratch, &chunk->alloc, &chunk->decls
+    );
+    chunk->decls.toks.alloc = serene_Trea_dyn(&chunk->alloc);
+    assert(Tokens_reserve(&chunk->decls.toks, chunk->source.len / 4 + 1) && "OOM");
+    for (
+        struct Token t = Scanner_next(&scanner);
+        t.kind != TK_EOF;
+        t = Scanner_next(&scanner)
+    ) {
+        assert(Tokens_push(&chunk->decls.toks, t) && "OOM");
+    }
+    chunk->stopped = scanner.lexer.rest.len > 0;
+    serene_Trea_deinit(scratch);
+}
+
+// out of the chunk's allocator, the parts are interned already
+static struct PIImport copy_import(struct serene_Trea* alloc, struct PIImport import) {
+    for (struct PIImport* last = &import; last->next; last = last->next) {
+        struct PIImport* tmp = serene_trealloc(alloc, struct PIImport);
+        assert(tmp && "OOM");
+        *tmp = *last->next;
+        last->next = tmp;
+    }
+    return import;
+}
+
+// appends the tokens and declarations of part to data's,
+// as if part was scanned right after
+static void scan_merge(
+    struct serene_Trea* alloc,
+    struct PIData* data,
+    struct PIData* part
+) {
+    if (!data->toks.alloc.alloc) data->toks.alloc = serene_Trea_dyn(alloc);
+    assert(Tokens_append(&data->toks, &part->toks) && "OOM");
+    assert(Opdecls_extend(&data->ops, part->ops.buf, part->ops.len));
+    // each list is newest first, so part's go in front
+    struct PIImports* rest = data->imports;
+    struct PIImports** tail = &data->imports;
+    for (ll_iter(imports, part->imports)) {
+        struct PIImports* tmp = serene_trealloc(alloc, struct PIImports);
+        assert(tmp && "OOM");
+        tmp->current = copy_import(alloc, imports->current);
+        *tail = tmp;
+        tail = &tmp->next;
+    }
+    *tail = rest;
+}
+
+// cuts source into up to jobs chunks that lex the same as the whole,
+// to be run through scan_chunk on the pool the module would've gone to
+static unsigned scan_split(
+    struct serene_Trea* alloc,
+    struct serene_Allocator backing,
+    struct Intern* intern,
+    struct String source,
+    unsigned jobs,
+    struct ScanChunk** out
+) {
+    assert(intern->concurrent && "chunked scans need a concurrent intern");
+    struct ScanChunk* chunks = serene_trenalloc(alloc, jobs, struct ScanChunk);
+    assert(chunks && "OOM");
+    unsigned count = 0;
+    for (size_t start = 0; start < source.len; count++) {
+        size_t target = (count + 1) * (source.len / jobs);
+        size_t end = count + 1 == jobs
+            ? source.len
+            : scan_restart_after(source, target > start ? target : start);
+        chunks[count] = (struct ScanChunk) {
+            .source = {&source.str[start], end - start},
+            .intern = intern,
+            .alloc = serene_Trea_init(backing),
+        };
+        serene_Trea_track(&chunks[count].alloc, &chunks[count].stats);
+        start = end;
+    }
+    *out = chunks;
+    return count;
+}
+
+// appends the tokens and declarations of the scanned chunks
+// in order, as if scanned in one go, and frees them
+static void scan_join(
+    struct serene_Trea* alloc,
+    struct ScanChunk* chunks,
+    unsigned count,
+    struct PIData* data,
+    struct serene_Stats* stats
+) {
+    data->toks.alloc = serene_Trea_dyn(alloc);
+    bool stopped = false;
+    for (unsigned i = 0; i < count; i++) {
+        struct ScanChunk* chunk = &chunks[i];
+        if (!stopped) {
+            scan_merge(alloc, data, &chunk->decls);
+            stopped = chunk->stopped;
+        }
+        Opdecls_deinit(&chunk->decls.ops);
+        serene_Trea_deinit(chunk->alloc);
+        if (stats) serene_Stats_merge(stats, chunk->stats);
+    }
+}
+
+static void* scan_mod(
+    struct serene_Trea* alloc,
+    struct serene_Trea* scratch,
+    struct Intern* intern,
+    struct MTreeFile* file,
+    bool stream
+) {
+    struct String* source = &file->source;
+    struct PIData* data = serene_trealloc(alloc, struct PIData);
+    assert(data && "OOM"), ZERO(*data);
+    struct Scanner scanner = Scanner_init(*source, intern, scratch, alloc, data);
+    if (stream) {
+        // the parser lexes it again, so it has to stay loaded until then
+        scan_decls(&scanner);
+        data->file = file;
         return data;
+    }
+    // roughly a token every four bytes, so big modules
+    // don't go through round after round of growing
+    data->toks.alloc = serene_Trea_dyn(alloc);
+    assert(Tokens_reserve(&data->toks, source->len / 4 + 1) && "OOM");
+    for (
+        struct Token t = Scanner_next(&scanner);
+        t.kind != TK_EOF;
+        t = Scanner_next(&scanner)
+    ) {
+        assert(Tokens_push(&data->toks, t) && "OOM");
+    }
+    return data;
 }
 
 struct Ctx {
     struct serene_Trea* alloc;
     struct serene_Trea* scratch;
     struct Intern* intern;
+    bool stream;
+    unsigned jobs;
+    // thread safe, what the workers' and chunks' allocators are built on
+    struct serene_Allocator backing;
+    // where those get counted once they're done
+    struct serene_Stats* stats;
+    // one each, for scanning modules on the workers
+    struct ScanWorker {
+        // the modules it scanned, until they're merged
+        struct serene_Trea alloc;
+        struct serene_Trea scratch;
+        struct serene_Stats stats;
+    }* workers;
+};
+
+struct ScanModule {
+    struct Ctx* ctx;
+    struct MTree* node;
+    // the directory its imports get resolved from
+    struct MTree* parent;
+    struct MTreeFile* file;
+    // on the allocator of the worker that scanned it, if there were any
+    struct PIData* data;
+    // when it's big enough to be lexed in pieces on the workers
+    struct ScanChunk* chunks;
+    unsigned chunk_count;
+    bool queued;
 };
 
-static void* scan_mod_ptr(void* _ctx, void* data) {
-    if (!data) return NULL;
-    struct Ctx* ctx = _ctx;
-    return scan_mod(ctx->alloc, ctx->scratch, ctx->intern, data);
+static void scan_module(void* _module, unsigned worker) {
+    struct ScanModule* module = _module;
+    struct Ctx* ctx = module->ctx;
+    struct ScanWorker* self = &ctx->workers[worker];
+    module->data = scan_mod(
+        &self->alloc, &self->scratch, ctx->intern,
+        module->file, ctx->stream
+    );
+}
+
+// the nodes with a module, in the order MTree_map visits them
+static size_t collect_modules(
+    struct MTree* this,
+    struct MTree* parent,
+    struct ScanModule* out,
+    size_t len
+) {
+    for (size_t i = 0; i < this->subs_count; i++) {
+        len = collect_modules(&this->subs[i], this, out, len);
+    }
+    if (this->data && out) {
+        out[len] = (struct ScanModule){.node = this, .parent = parent, .file = this->data};
+    }
+    return this->data ? len + 1 : len;
+}
+
+static int scan_module_cmp(const void* _lhs, const void* _rhs) {
+    const struct MTree* lhs = ((const struct ScanModule*) _lhs)->node;
+    const struct MTree* rhs = ((const struct ScanModule*) _rhs)->node;
+    return (lhs > rhs) - (lhs < rhs);
 }
 
-static void cleanup(void* _data) {
-    if (!_data) return;
-    struct String* data = _data;
-    // yes gcc we know data->str is const
-    munmap((char*)data->str, data->len);
+static int scan_module_bigger(const void* _lhs, const void* _rhs) {
+    size_t lhs = (*(struct ScanModule* const*) _lhs)->file->source.len;
+    size_t rhs = (*(struct ScanModule* const*) _rhs)->file->source.len;
+    return (lhs < rhs) - (lhs > rhs);
+}
+
+// the module an import names, resolved the same way preimport does;
+// NULL when it names a directory without one
+static struct ScanModule* scan_resolve(
+    struct ScanModule* modules,
+    size_t len,
+    struct MTree* row,
+    struct PIImport* import
+) {
+    struct MTree* mod = row;
+    for (ll_iter(part, import)) {
+        struct MTree* tmp = MTree_index(mod, part->part);
+        if (!part->next && !tmp) break;
+        assert(tmp && "tried importing from a nonexistent module");
+        mod = tmp;
+    }
+    struct ScanModule key = {.node = mod};
+    return bsearch(&key, modules, len, sizeof(*modules), scan_module_cmp);
+}
+
+// the round's modules are scanned all at once on the workers, then
+// copied out of the workers' allocators in the order they were found
+static void scan_round(struct Ctx* ctx, struct Workers* pool, struct ScanModule** round, size_t len) {
+    struct serene_TreaMark mark = serene_Trea_mark(ctx->scratch);
+    struct ScanModule** by_size = serene_trenalloc(ctx->scratch, len, struct ScanModule*);
+    assert(by_size && "OOM");
+    for (size_t i = 0; i < len; i++) by_size[i] = round[i];
+    // biggest first, so a big one doesn't come in last and hold up the rest
+    qsort(by_size, len, sizeof(*by_size), scan_module_bigger);
+    // big ones go in as chunks on the same pool, so a round
+    // never has more than jobs threads lexing at once
+    for (size_t i = 0; i < len; i++) {
+        struct ScanModule* module = by_size[i];
+        struct String source = module->file->source;
+        if (ctx->stream || source.len < SCAN_CHUNKED_MIN) {
+            Workers_submit(pool, (struct WorkersTask){scan_module, module});
+            continue;
+        }
+        module->chunk_count = scan_split(
+            ctx->scratch, ctx->backing, ctx->intern, source, ctx->jobs, &module->chunks
+        );
+        for (unsigned j = 0; j < module->chunk_count; j++) {
+            Workers_submit(pool, (struct WorkersTask){scan_chunk, &module->chunks[j]});
+        }
+    }
+    Workers_wait(pool);
+
+    for (size_t i = 0; i < len; i++) {
+        if (round[i]->chunks) {
+            struct PIData* data = serene_trealloc(ctx->alloc, struct PIData);
+            assert(data && "OOM"), ZERO(*data);
+            scan_join(ctx->alloc, round[i]->chunks, round[i]->chunk_count, data, ctx->stats);
+            round[i]->data = data;
+            round[i]->chunks = NULL;
+            continue;
+        }
+        struct PIData* part = round[i]->data;
+        struct PIData* data = serene_trealloc(ctx->alloc, struct PIData);
+        assert(data && "OOM"), ZERO(*data);
+        scan_merge(ctx->alloc, data, part);
+        data->file = part->file;
+        Opdecls_deinit(&part->ops);
+        round[i]->data = data;
+    }
+    serene_Trea_reset(ctx->scratch, mark);
+}
+
+static double scan_now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
 }
 
 struct MTree* scan(
     struct serene_Trea* alloc,
+    struct serene_Allocator backing,
     struct Intern* intern,
-    struct MTree* mods
+    struct MTree* mods,
+    struct String main,
+    bool stream,
+    unsigned jobs,
+    struct serene_Stats* stats,
+    double* load_ms
 ) {
+    assert((jobs == 1 || intern->concurrent) && "parallel scans need a concurrent intern");
     struct serene_Trea scratch = serene_Trea_sub(&intern->alloc);
-    struct Ctx ctx = {alloc, &scratch, intern};
-    MTree_map(mods, cleanup, scan_mod_ptr, &ctx);
+    struct Ctx ctx = {alloc, &scratch, intern, stream, jobs, backing, stats, NULL};
+
+    // every module starts out unloaded, sorted by node so imports can be
+    // looked up, and only the ones found through imports get a PIData
+    size_t len = collect_modules(mods, NULL, NULL, 0);
+    struct ScanModule* modules = serene_trenalloc(&scratch, len, struct ScanModule);
+    struct ScanModule** queue = serene_trenalloc(&scratch, len, struct ScanModule*);
+    assert(modules && queue && "OOM");
+    collect_modules(mods, NULL, modules, 0);
+    for (size_t i = 0; i < len; i++) {
+        modules[i].ctx = &ctx;
+        modules[i].node->data = NULL;
+    }
+    qsort(modules, len, sizeof(*modules), scan_module_cmp);
+
+    struct MTree* main_node = MTree_index(mods, main);
+    struct ScanModule key = {.node = main_node};
+    struct ScanModule* first = main_node
+        ? bsearch(&key, modules, len, sizeof(*modules), scan_module_cmp)
+        : NULL;
+    assert(first && "main module not found");
+    first->queued = true;
+    queue[0] = first;
+    size_t queued = 1;
+
+    // small modules get read in here, past the scan
+    // they're only needed when the parser lexes them again
+    struct serene_Trea sources = serene_Trea_sub(alloc);
+    struct serene_Trea* arena = stream ? alloc : &sources;
+    *load_ms = 0;
+
+    struct ScanWorker workers[jobs];
+    struct Workers pool;
+    if (jobs > 1) {
+        for (unsigned i = 0; i < jobs; i++) {
+            workers[i].stats = (struct serene_Stats) {0};
+            workers[i].alloc = serene_Trea_init(backing);
+            serene_Trea_track(&workers[i].alloc, &workers[i].stats);
+            workers[i].scratch = serene_Trea_sub(&workers[i].alloc);
+        }
+        ctx.workers = workers;
+        Workers_init(&pool, serene_Libc_dyn(), jobs);
+    }
+
+    // a round is everything the previous one imported for the first time
+    for (size_t done = 0; done < queued;) {
+        size_t end = queued;
+        double start = scan_now_ms();
+        for (size_t i = done; i < end; i++) {
+            assert(MTreeFile_load(queue[i]->file, arena) && "couldn't open module");
+        }
+        *load_ms += scan_now_ms() - start;
+        if (jobs > 1) {
+            scan_round(&ctx, &pool, &queue[done], end - done);
+        } else {
+            for (size_t i = done; i < end; i++) {
+                queue[i]->data = scan_mod(alloc, &scratch, intern, queue[i]->file, stream);
+            }
+        }
+        for (; done < end; done++) {
+            struct ScanModule* module = queue[done];
+            module->node->data = module->data;
+            // the parser unloads streamed files once it's done with them
+            if (!stream) MTreeFile_unload(module->file);
+            for (ll_iter(import, module->data->imports)) {
+                struct ScanModule* found = scan_resolve(modules, len, module->parent, &import->current);
+                if (!found || found->queued) continue;
+                found->queued = true;
+                queue[queued++] = found;
+            }
+        }
+    }
+
+    if (jobs > 1) {
+        Workers_deinit(&pool);
+        for (unsigned i = 0; i < jobs; i++) {
+            serene_Trea_deinit(workers[i].scratch);
+            serene_Trea_deinit(workers[i].alloc);
+            if (stats) serene_Stats_merge(stats, workers[i].stats);
+        }
+    }
+    serene_Trea_deinit(sources);
     serene_Trea_deinit(scratch);
     return mods;
 }
@@ -1,10 +1,11 @@
 #ifndef OPSCAN_H
 #define OPSCAN_H
 
+#include "lexer.h"
 #include "mtree.h"
 #include "strings.h"
 #include "opdeclvec.h"
-#include "tokenvec.h"
+#include "tokens.h"
 #include "serene.h"
 
 struct PIImport {
@@ -18,12 +19,56 @@ struct PIImports {
 };
 
 struct PIData {
-    struct Tokenvec toks;
+    struct Tokens toks;
     struct Opdecls ops;
     struct PIImports* imports;
+    // when streaming, toks stays empty and the parser lexes
+    // the still loaded file instead
+    struct MTreeFile* file;
 };
 
+// lexes tokens the way the parser wants them: comments dropped,
+// adjacent string literals joined and everything interned;
+// operator and import declarations go to decls, or get skipped
+// when it's NULL since an earlier pass gathered them already
+struct Scanner {
+    struct Lexer lexer;
+    // the raw token up next
+    struct Token t;
+    struct Intern* intern;
+    // for joining string literals, reset after each one
+    struct serene_Trea* scratch;
+    // imports get allocated here
+    struct serene_Trea* alloc;
+    struct PIData* decls;
+};
+
+struct Scanner Scanner_init(
+    struct String source,
+    struct Intern*,
+    struct serene_Trea* scratch,
+    struct serene_Trea* alloc,
+    struct PIData* decls
+);
+// TK_EOF at the end
+struct Token Scanner_next(struct Scanner*);
+
 void PIData_print(void*);
-struct MTree* scan(struct serene_Trea* alloc, struct Intern*, struct MTree*);
+// with more than one job the modules are scanned on that many
+// workers and ones at least this big are lexed in up to jobs
+// chunks on those same workers, both need a concurrent Intern
+#define SCAN_CHUNKED_MIN (1 << 20)
+
+// loads and scans the main module and whatever it imports, round after
+// round, the other modules are left without data;
+// when streaming only declarations are gathered up front;
+// the workers' allocators are built on backing, which has to be thread
+// safe, and counted in stats once they're done;
+// the time spent reading modules in goes to load_ms
+struct MTree* scan(
+    struct serene_Trea* alloc, struct serene_Allocator backing,
+    struct Intern*, struct MTree*, struct String main, bool stream,
+    unsigned jobs, struct serene_Stats* stats, double* load_ms
+);
 
 #endif
@@ -0,0 +1,89 @@
+#include "./optable.h"
+#include "commons.h"
+#include <assert.h>
+
+#define Optable_chunk_mask (Optable_chunk_len - 1)
+
+static void optable_grow(struct Optable* this, struct serene_Trea* alloc, size_t len) {
+    if (len <= this->len) return;
+    if (len < this->len * 2) len = this->len * 2;
+    struct Opchunk** chunks = serene_trenalloc(alloc, len, struct Opchunk*);
+    assert(chunks && "OOM");
+    for (size_t i = 0; i < len; i++) chunks[i] = i < this->len ? this->chunks[i] : NULL;
+    this->chunks = chunks;
+    this->len = len;
+}
+
+// the chunk at, copied first unless this table made it
+static struct Opchunk* optable_own(struct Optable* this, struct serene_Trea* alloc, size_t at) {
+    struct Opchunk* chunk = this->chunks[at];
+    if (chunk && chunk->owner == this) return chunk;
+    struct Opchunk* new = serene_trealloc(alloc, struct Opchunk);
+    assert(new && "OOM");
+    if (chunk) *new = *chunk;
+    else ZERO(*new);
+    new->owner = this;
+    this->chunks[at] = new;
+    return new;
+}
+
+// whether from has a form entry is missing
+static bool optable_adds(const struct Opentry* entry, const struct Opentry* from) {
+    if (!from->token.str) return false;
+    if (!entry->token.str) return true;
+    return (entry->prefix < 0 && from->prefix >= 0) || (entry->lbp < 0 && from->lbp >= 0);
+}
+
+static void optable_merge(struct Optable* this, struct Opentry* entry, const struct Opentry* from) {
+    if (!entry->token.str) {
+        *entry = *from;
+        this->count++;
+        return;
+    }
+    if (entry->prefix < 0) entry->prefix = from->prefix;
+    if (entry->lbp < 0) {
+        entry->lbp = from->lbp;
+        entry->rbp = from->rbp;
+    }
+}
+
+void Optable_declare(struct Optable* this, struct serene_Trea* alloc, struct Opdecl decl) {
+    bool infix = decl.lbp >= 0;
+    struct Opentry from = {
+        .token = decl.token,
+        .prefix = !infix && decl.rbp >= 0 ? decl.rbp : -1,
+        .lbp = infix ? decl.lbp : -1,
+        .rbp = infix ? decl.rbp : -1,
+    };
+    size_t at = decl.sym >> Optable_chunk_bits;
+    size_t idx = decl.sym & Optable_chunk_mask;
+    optable_grow(this, alloc, at + 1);
+    if (this->chunks[at] && !optable_adds(&this->chunks[at]->entries[idx], &from)) return;
+    optable_merge(this, &optable_own(this, alloc, at)->entries[idx], &from);
+}
+
+void Optable_import(struct Optable* this, struct serene_Trea* alloc, const struct Optable* other) {
+    optable_grow(this, alloc, other->len);
+    for (size_t at = 0; at < other->len; at++) {
+        struct Opchunk* theirs = other->chunks[at];
+        if (!theirs || theirs == this->chunks[at]) continue;
+        if (!this->chunks[at]) {
+            this->chunks[at] = theirs;
+            for (size_t i = 0; i < Optable_chunk_len; i++) {
+                if (theirs->entries[i].token.str) this->count++;
+            }
+            continue;
+        }
+        for (size_t i = 0; i < Optable_chunk_len; i++) {
+            if (!optable_adds(&this->chunks[at]->entries[i], &theirs->entries[i])) continue;
+            optable_merge(this, &optable_own(this, alloc, at)->entries[i], &theirs->entries[i]);
+        }
+    }
+}
+
+const struct Opentry* Optable_get(const struct Optable* this, uint32_t sym) {
+    size_t at = sym >> Optable_chunk_bits;
+    if (at >= this->len || !this->chunks[at]) return NULL;
+    const struct Opentry* entry = &this->chunks[at]->entries[sym & Optable_chunk_mask];
+    return entry->token.str ? entry : NULL;
+}
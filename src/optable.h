@@ -0,0 +1,46 @@
+#ifndef OPTABLE_H
+#define OPTABLE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "opdecl.h"
+#include "serene.h"
+#include "strings.h"
+
+// how an operator parses, the first declaration of each form wins
+struct Opentry {
+    // NULL when the symbol isn't an operator
+    struct String token;
+    // binding power of the prefix form, < 0 if there's none
+    int prefix;
+    // of the infix or postfix form, lbp < 0 if there's none
+    // and rbp < 0 for postfix
+    int lbp;
+    int rbp;
+};
+
+#define Optable_chunk_bits 6
+#define Optable_chunk_len (1 << Optable_chunk_bits)
+
+// the operators in scope of a module by symbol id, in chunks
+// that are shared with the tables of the modules it imports,
+// until a declaration lands in one and it gets copied
+struct Optable {
+    struct Opchunk {
+        // only the table that made a chunk writes to it
+        const struct Optable* owner;
+        struct Opentry entries[Optable_chunk_len];
+    }** chunks;
+    size_t len;
+    // operators in scope
+    size_t count;
+};
+
+void Optable_declare(struct Optable*, struct serene_Trea*, struct Opdecl);
+// declarations already in this take precedence
+void Optable_import(struct Optable*, struct serene_Trea*, const struct Optable*);
+// NULL if the symbol isn't an operator
+const struct Opentry* Optable_get(const struct Optable*, uint32_t sym);
+
+#endif
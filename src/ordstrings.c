@@ -1,4 +1,5 @@
 #include "ordstrings.h"
+#include <limits.h>
 #include <stdio.h>
 
 int Ordstring_cmp(struct Ordstring a, struct Ordstring b) {
@@ -12,4 +13,16 @@ int Ordstring_cmp(struct Ordstring a, struct Ordstring b) {
     return 0;
 }
 
+// length first, like the compare, then the first two chars,
+// with the sign bit flipped where chars compare as signed
+uint32_t Ordstring_prefix(struct Ordstring s) {
+    uint32_t len = s.len < 0xffff ? s.len : 0xffff;
+    uint32_t out = len << 16;
+    if (len == 0xffff) return out;
+    for (size_t i = 0; i < 2 && i < s.len; i++) {
+        out |= (uint32_t) ((uint8_t) s.str[i] ^ (CHAR_MIN < 0 ? 0x80 : 0)) << (8 - 8 * i);
+    }
+    return out;
+}
+
 void Ordstring_print(struct Ordstring s) { printf("%.*s", (int) s.len, s.str); }
@@ -2,6 +2,7 @@
 #define ORDSTRINGS_H
 
 #include <stddef.h>
+#include <stdint.h>
 
 struct Ordstring {
     const char *str;
@@ -9,6 +10,8 @@ struct Ordstring {
 };
 
 int Ordstring_cmp(struct Ordstring, struct Ordstring);
+// a < b whenever prefix(a) < prefix(b), equal ones need the full compare
+uint32_t Ordstring_prefix(struct Ordstring);
 void Ordstring_print(struct Ordstring);
 
 #endif
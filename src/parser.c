@@ -9,15 +9,18 @@ void PTData_print(void* _data) {
 
 struct Context {
     struct serene_Trea* alloc;
-    struct Opdecls ops;
+    // symbols interned while streaming are past its end and never operators
+    const struct Optable* ops;
     struct TypeIntern* intern;
+    struct Literals* literals;
     struct Tokenstream toks;
 };
 
 static struct Ast parse_top(
     struct serene_Trea* alloc,
-    struct Opdecls ops,
+    const struct Optable* ops,
     struct TypeIntern* intern,
+    struct Literals* literals,
     struct Tokenstream toks
 );
 
@@ -61,60 +64,84 @@ static struct Expr statement_assign(struct Context *);
 struct Ctx {
     struct serene_Trea* alloc;
     struct Symbols* symbols;
+    struct Literals* literals;
 };
 
-static void* parse_ptr(void* _ctx, void* _data) {
-    struct Ctx* ctx = _ctx;
-    struct PPData* data = _data;
-    if (!data) return data;
-    struct Tokenstream toks = {
-        data->toks.buf,
-        data->toks.len
-    };
-    struct PTData* new = serene_trealloc(ctx->alloc, struct PTData);
+static struct Token pull(void* scanner) {
+    return Scanner_next(scanner);
+}
+
+struct PTData* parse_module(
+    struct serene_Trea* alloc,
+    struct Symbols* symbols,
+    struct Literals* literals,
+    struct PPData* data
+) {
+    struct Tokenstream toks = Tokens_stream(&data->toks, symbols->strings);
+    // declarations were gathered by scan already, so the scanner skips them
+    struct serene_Trea scratch = serene_Trea_sub(alloc);
+    struct Scanner scanner = Scanner_init(
+        data->file ? data->file->source : (struct String){0},
+        symbols->strings, &scratch, alloc, NULL
+    );
+    if (data->file) toks = Tokenstream_pulling(pull, &scanner);
+
+    struct PTData* new = serene_trealloc(alloc, struct PTData);
     assert(new && "OOM"), ZERO(*new);
     new->imports = data->imports;
-    new->types = TypeIntern_init(ctx->alloc, *ctx->symbols);
+    new->types = TypeIntern_init(alloc, *symbols);
     new->ast = parse_top(
-        ctx->alloc,
-        data->ops,
+        alloc,
+        &data->ops,
         &new->types,
+        literals,
         toks
     );
+    serene_Trea_deinit(scratch);
     return new;
 }
 
-static void cleanup(void* _data) {
-    struct PPData* data = _data;
-    if (!data) return;
-    Opdecls_deinit(&data->ops);
-    Tokenvec_deinit(&data->toks);
+void parse_cleanup(struct PPData* data) {
+    Tokens_deinit(&data->toks);
+    if (data->file) MTreeFile_unload(data->file);
+}
+
+static void* parse_ptr(void* _ctx, void* data) {
+    struct Ctx* ctx = _ctx;
+    if (!data) return data;
+    return parse_module(ctx->alloc, ctx->symbols, ctx->literals, data);
+}
+
+static void cleanup(void* data) {
+    if (data) parse_cleanup(data);
 }
 
 struct MTree* parse(
     struct serene_Trea* alloc,
     struct Symbols* symbols,
+    struct Literals* literals,
     struct MTree* mod
 ) {
-    struct Ctx ctx = {alloc, symbols};
+    struct Ctx ctx = {alloc, symbols, literals};
     MTree_map(mod, cleanup, parse_ptr, &ctx);
     return mod;
 }
 
 static struct Ast parse_top(
-    struct serene_Trea* alloc, struct Opdecls ops,
-    struct TypeIntern *intern, struct Tokenstream toks
+    struct serene_Trea* alloc, const struct Optable* ops, struct TypeIntern *intern,
+    struct Literals* literals, struct Tokenstream toks
 ) {
     struct Context ctx = {
         .alloc = alloc,
         .ops = ops,
         .intern = intern,
+        .literals = literals,
         .toks = toks,
     };
     struct FunctionsLL* funcs = NULL;
 
     while (true) {
-        switch (Tokenstream_peek(&ctx.toks).kind) {
+        switch (Tokenstream_peek_kind(&ctx.toks)) {
         case TK_Func: {
             struct FunctionsLL *tmp = serene_trealloc(alloc, struct FunctionsLL);
             assert(tmp && "OOM");
@@ -129,7 +156,7 @@ static struct Ast parse_top(
     }
 after:
     printf("last tokens is: %s\n", Tokenstream_peek(&ctx.toks).spelling.str);
-    assert(Tokenstream_peek(&ctx.toks).kind == TK_EOF);
+    assert(Tokenstream_peek_kind(&ctx.toks) == TK_EOF);
 
     return (struct Ast){
         .funcs = funcs,
@@ -138,6 +165,7 @@ after:
 
 static struct Function decls_function(struct Context *ctx) {
     struct String name;
+    uint32_t sym;
     struct Binding args;
     struct Type const *ret;
     struct Expr body;
@@ -145,6 +173,7 @@ static struct Function decls_function(struct Context *ctx) {
     assert(Tokenstream_drop_kind(&ctx->toks, TK_Func));
 
     name = Tokenstream_peek(&ctx->toks).spelling;
+    sym = Tokenstream_peek(&ctx->toks).sym;
     assert(Tokenstream_drop_kind(&ctx->toks, TK_Name));
 
     args = binding_parenthesised(ctx);
@@ -161,11 +190,17 @@ static struct Function decls_function(struct Context *ctx) {
         Tokenstream_drop_kind(&ctx->toks, TK_Semicolon);
     };
 
-    return (struct Function){.name = name, .args = args, .ret = ret, .body = body};
+    return (struct Function){
+        .name = name,
+        .sym = sym,
+        .args = args,
+        .ret = ret,
+        .body = body,
+    };
 }
 
 static struct Type const *type(struct Context *ctx) {
-    if (Tokenstream_peek(&ctx->toks).kind == TK_Func)
+    if (Tokenstream_peek_kind(&ctx->toks) == TK_Func)
         return type_func(ctx);
     return type_op(ctx, 0);
 }
@@ -181,7 +216,7 @@ static struct Type const *type_func(struct Context *ctx) {
 static struct Type const *type_op(struct Context *ctx, unsigned prec) {
     struct Type const *left;
 
-    switch (Tokenstream_peek(&ctx->toks).kind) {
+    switch (Tokenstream_peek_kind(&ctx->toks)) {
     case TK_Name:
     case TK_OpenParen:
         left = type_atom(ctx);
@@ -199,26 +234,20 @@ static struct Type const *type_op(struct Context *ctx, unsigned prec) {
 static struct Type const *type_op_left(struct Context *ctx) {
     struct Type const *args;
     struct Type const *name;
+    struct Token op = Tokenstream_peek(&ctx->toks);
+    const struct Opentry* entry = Optable_get(ctx->ops, op.sym);
+    assert(entry && entry->prefix >= 0 && "unexpected token");
 
-    for (size_t i = 0; i < ctx->ops.len; i++) {
-        if (ctx->ops.buf[i].lbp >= 0 || ctx->ops.buf[i].rbp < 0)
-            continue;
-        if (Tokenstream_peek(&ctx->toks).spelling.str != ctx->ops.buf[i].token.str)
-            continue;
-
-        name = Type_recall(ctx->intern, Tokenstream_peek(&ctx->toks).spelling);
-
-        assert(Tokenstream_drop(&ctx->toks));
-        args = type_op(ctx, ctx->ops.buf[i].rbp);
+    name = Type_recall(ctx->intern, op.spelling, op.sym);
 
-        return Type_call(ctx->intern, name, args);
-    }
+    assert(Tokenstream_drop(&ctx->toks));
+    args = type_op(ctx, entry->prefix);
 
-    assert(false && "unexpected token");
+    return Type_call(ctx->intern, name, args);
 }
 
 static bool type_op_right_first(struct Context *ctx, unsigned prec) {
-    switch (Tokenstream_peek(&ctx->toks).kind) {
+    switch (Tokenstream_peek_kind(&ctx->toks)) {
     case TK_OpenParen:
     case TK_Name:
         return true;
@@ -226,16 +255,8 @@ static bool type_op_right_first(struct Context *ctx, unsigned prec) {
         break;
     }
 
-    for (size_t i = 0; i < ctx->ops.len; i++) {
-        if (ctx->ops.buf[i].lbp < (int)prec)
-            continue;
-        // same as for type_op_left()
-        if (Tokenstream_peek(&ctx->toks).spelling.str != ctx->ops.buf[i].token.str)
-            continue;
-        return true;
-    }
-
-    return false;
+    const struct Opentry* entry = Optable_get(ctx->ops, Tokenstream_peek(&ctx->toks).sym);
+    return entry && entry->lbp >= (int)prec;
 }
 
 static struct Type const* type_op_right(
@@ -245,44 +266,42 @@ static struct Type const* type_op_right(
 ) {
     struct Type const* name;
     struct Type const *args;
-    switch (Tokenstream_peek(&ctx->toks).kind) {
+    switch (Tokenstream_peek_kind(&ctx->toks)) {
     case TK_OpenParen:
     case TK_Name:
         name = left;
         args = type_atom(ctx);
         return Type_call(ctx->intern, name, args);
-    default:
-        for (size_t i = 0; i < ctx->ops.len; i++) {
-            if (ctx->ops.buf[i].lbp < (int)prec)
-                continue;
-            if (Tokenstream_peek(&ctx->toks).spelling.str != ctx->ops.buf[i].token.str)
-                continue;
-
-            name = Type_recall(ctx->intern, Tokenstream_peek(&ctx->toks).spelling);
-            assert(Tokenstream_drop(&ctx->toks));
-            if (ctx->ops.buf[i].rbp >= 0) {
-                const struct Type *right = type_op(ctx, ctx->ops.buf[i].rbp);
-                args = Type_tuple(ctx->intern, left, right);
-            } else {
-                args = left;
-            }
+    default: {
+        struct Token op = Tokenstream_peek(&ctx->toks);
+        const struct Opentry* entry = Optable_get(ctx->ops, op.sym);
+        if (!entry || entry->lbp < (int)prec) break;
 
-            return Type_call(ctx->intern, name, args);
+        name = Type_recall(ctx->intern, op.spelling, op.sym);
+        assert(Tokenstream_drop(&ctx->toks));
+        if (entry->rbp >= 0) {
+            const struct Type *right = type_op(ctx, entry->rbp);
+            args = Type_tuple(ctx->intern, left, right);
+        } else {
+            args = left;
         }
+
+        return Type_call(ctx->intern, name, args);
+    }
     }
 
     assert(false && "unexpected token");
 }
 
 static const struct Type *type_atom(struct Context *ctx) {
-    switch (Tokenstream_peek(&ctx->toks).kind) {
+    switch (Tokenstream_peek_kind(&ctx->toks)) {
     case TK_OpenParen:
         return type_parenthesised(ctx);
     case TK_Name: {
-        struct String name = Tokenstream_peek(&ctx->toks).spelling;
+        struct Token name = Tokenstream_peek(&ctx->toks);
         Tokenstream_drop(&ctx->toks);
 
-        return Type_recall(ctx->intern, name);
+        return Type_recall(ctx->intern, name.spelling, name.sym);
     }
     default:
         assert(false && "unexpected token encountered");
@@ -292,20 +311,20 @@ static const struct Type *type_atom(struct Context *ctx) {
 static const struct Type *type_parenthesised(struct Context *ctx) {
     assert(Tokenstream_drop_kind(&ctx->toks, TK_OpenParen));
     const struct Type* out = type(ctx);
-    if (Tokenstream_peek(&ctx->toks).kind == TK_Semicolon) {
+    if (Tokenstream_peek_kind(&ctx->toks) == TK_Semicolon) {
         assert(Tokenstream_drop(&ctx->toks));
-        int n = Tokenstream_peek(&ctx->toks).number;
+        int n = Literal_int(Tokenstream_peek(&ctx->toks).number);
         assert(Tokenstream_drop_kind(&ctx->toks, TK_Number));
         const struct Type* type = out;
         for (int i = 1; i < n; i++)
             out = Type_tuple_extend(ctx->intern, out, type);
     }
-    while (Tokenstream_peek(&ctx->toks).kind == TK_Comma) {
+    while (Tokenstream_peek_kind(&ctx->toks) == TK_Comma) {
         assert(Tokenstream_drop(&ctx->toks));
         const struct Type* rhs = type(ctx);
-        if (Tokenstream_peek(&ctx->toks).kind == TK_Semicolon) {
+        if (Tokenstream_peek_kind(&ctx->toks) == TK_Semicolon) {
             assert(Tokenstream_drop(&ctx->toks));
-            int n = Tokenstream_peek(&ctx->toks).number;
+            int n = Literal_int(Tokenstream_peek(&ctx->toks).number);
             assert(Tokenstream_drop_kind(&ctx->toks, TK_Number));
             for (int i = 0; i < n; i++)
                 out = Type_tuple_extend(ctx->intern, out, rhs);
@@ -320,7 +339,7 @@ static const struct Type *type_parenthesised(struct Context *ctx) {
 static struct Binding binding(struct Context *ctx) { return binding_atom(ctx); }
 
 static struct Binding binding_atom(struct Context *ctx) {
-    if (Tokenstream_peek(&ctx->toks).kind == TK_OpenParen) {
+    if (Tokenstream_peek_kind(&ctx->toks) == TK_OpenParen) {
         return binding_parenthesised(ctx);
     }
     return binding_name(ctx);
@@ -329,9 +348,9 @@ static struct Binding binding_atom(struct Context *ctx) {
 static struct Binding binding_parenthesised(struct Context* ctx) {
     struct Binding out = {0};
     assert(Tokenstream_drop_kind(&ctx->toks, TK_OpenParen));
-    if (Tokenstream_peek(&ctx->toks).kind != TK_CloseParen) {
+    if (Tokenstream_peek_kind(&ctx->toks) != TK_CloseParen) {
         out = binding(ctx);
-        if (Tokenstream_peek(&ctx->toks).kind == TK_Comma) {
+        if (Tokenstream_peek_kind(&ctx->toks) == TK_Comma) {
             struct BindingTuple* node = serene_trealloc(ctx->alloc, struct BindingTuple);
             assert(node && "OOM");
             *node = (struct BindingTuple){0};
@@ -339,7 +358,7 @@ static struct Binding binding_parenthesised(struct Context* ctx) {
             out = (struct Binding){.tag = BT_Tuple, .tuple = node};
 
             struct BindingTuple* last = node;
-            while (Tokenstream_peek(&ctx->toks).kind == TK_Comma) {
+            while (Tokenstream_peek_kind(&ctx->toks) == TK_Comma) {
                 assert(Tokenstream_drop(&ctx->toks));
                 struct BindingTuple* tmp = serene_trealloc(ctx->alloc, struct BindingTuple);
                 assert(tmp && "OOM");
@@ -358,10 +377,10 @@ static struct Binding binding_parenthesised(struct Context* ctx) {
 }
 
 static struct Binding binding_name(struct Context *ctx) {
-    struct String name = Tokenstream_peek(&ctx->toks).spelling;
+    struct Token name = Tokenstream_peek(&ctx->toks);
     assert(Tokenstream_drop_kind(&ctx->toks, TK_Name));
     const struct Type *annot;
-    if (Tokenstream_peek(&ctx->toks).kind == TK_Colon) {
+    if (Tokenstream_peek_kind(&ctx->toks) == TK_Colon) {
         assert(Tokenstream_drop(&ctx->toks));
         annot = type(ctx);
     } else {
@@ -370,13 +389,14 @@ static struct Binding binding_name(struct Context *ctx) {
 
     return (struct Binding){
         .tag = BT_Name,
-        .name.name = name,
+        .name.name = name.spelling,
+        .name.sym = name.sym,
         .name.annot = annot,
     };
 }
 
 static struct Expr expr_delimited(struct Context *ctx) {
-    switch (Tokenstream_peek(&ctx->toks).kind) {
+    switch (Tokenstream_peek_kind(&ctx->toks)) {
     case TK_If:
     case TK_Loop:
     case TK_OpenBrace: {
@@ -394,7 +414,7 @@ static struct Expr expr_delimited(struct Context *ctx) {
 }
 
 static struct Expr expr_any(struct Context *ctx) {
-    switch (Tokenstream_peek(&ctx->toks).kind) {
+    switch (Tokenstream_peek_kind(&ctx->toks)) {
     case TK_If:
     case TK_Loop:
     case TK_OpenBrace:
@@ -405,7 +425,7 @@ static struct Expr expr_any(struct Context *ctx) {
 }
 
 static struct Expr expr_block(struct Context *ctx) {
-    switch (Tokenstream_peek(&ctx->toks).kind) {
+    switch (Tokenstream_peek_kind(&ctx->toks)) {
     case TK_If:
         return expr_if(ctx);
     case TK_Loop:
@@ -446,7 +466,7 @@ static struct Expr expr_bareblock(struct Context *ctx) {
     const struct Type *type = ctx->intern->tsyms.t_unit;
 
     assert(Tokenstream_drop_kind(&ctx->toks, TK_OpenBrace));
-    while (Tokenstream_peek(&ctx->toks).kind != TK_CloseBrace) {
+    while (Tokenstream_peek_kind(&ctx->toks) != TK_CloseBrace) {
         {
             struct ExprsLL* tmp = serene_trealloc(ctx->alloc, struct ExprsLL);
             *tmp = (typeof(*tmp)){0};
@@ -476,7 +496,7 @@ static struct Expr expr_inline(struct Context* ctx) {
 static struct Expr expr_op(struct Context *ctx, unsigned prec) {
     struct Expr left;
 
-    switch (Tokenstream_peek(&ctx->toks).kind) {
+    switch (Tokenstream_peek_kind(&ctx->toks)) {
     case TK_Name:
     case TK_OpenParen:
     case TK_Number:
@@ -499,29 +519,21 @@ static struct Expr expr_op_left(struct Context *ctx) {
     struct ExprCall* call = serene_trealloc(ctx->alloc, struct ExprCall);
     assert(call && "OOM");
 
-    for (size_t i = 0; i < ctx->ops.len; i++) {
-        if (ctx->ops.buf[i].lbp >= 0 || ctx->ops.buf[i].rbp < 0)
-            continue;
-        if (Tokenstream_peek(&ctx->toks).spelling.str != ctx->ops.buf[i].token.str)
-            continue;
-
-        assert(Tokenstream_drop(&ctx->toks));
-        struct Expr name = Expr_recall(ctx->intern, ctx->ops.buf[i].token);
-        struct Expr args = expr_op(ctx, ctx->ops.buf[i].rbp);
-        return Expr_call(ctx->alloc, ctx->intern, name, args);
-    }
+    uint32_t sym = Tokenstream_peek(&ctx->toks).sym;
+    const struct Opentry* entry = Optable_get(ctx->ops, sym);
+    assert(entry && entry->prefix >= 0 && "unexpected token");
 
-    assert(false && "unexpected token");
+    assert(Tokenstream_drop(&ctx->toks));
+    struct Expr name = Expr_recall(ctx->intern, entry->token, sym);
+    struct Expr args = expr_op(ctx, entry->prefix);
+    return Expr_call(ctx->alloc, ctx->intern, name, args);
 }
 
 static bool expr_op_right_first(struct Context* ctx, unsigned prec) {
     struct Token op = Tokenstream_peek(&ctx->toks);
-    for (size_t i = 0; i < ctx->ops.len; i++) {
-        if (op.spelling.str != ctx->ops.buf[i].token.str)
-            continue;
-        if (ctx->ops.buf[i].lbp < (int)prec)
-            return false;
-        return true;
+    const struct Opentry* entry = Optable_get(ctx->ops, op.sym);
+    if (entry) {
+        return entry->lbp >= (int)prec;
     }
 
     switch (op.kind) {
@@ -545,22 +557,18 @@ static struct Expr expr_op_right(
 ) {
     struct Token op = Tokenstream_peek(&ctx->toks);
     switch (op.kind) {
-    case TK_Name:
-        for (size_t i = 0; i < ctx->ops.len; i++) {
-            if (op.spelling.str != ctx->ops.buf[i].token.str)
-                continue;
-            if (ctx->ops.buf[i].lbp < (int)prec)
-                continue;
-
+    case TK_Name: {
+        const struct Opentry* entry = Optable_get(ctx->ops, op.sym);
+        if (entry && entry->lbp >= (int)prec) {
             assert(Tokenstream_drop(&ctx->toks));
-            struct Expr name = Expr_recall(ctx->intern, ctx->ops.buf[i].token);
+            struct Expr name = Expr_recall(ctx->intern, entry->token, op.sym);
             struct Expr args;
-            if (ctx->ops.buf[i].rbp >= 0) {
+            if (entry->rbp >= 0) {
                 args = Expr_tuple(
                     ctx->alloc,
                     ctx->intern,
                     left,
-                    expr_op(ctx, ctx->ops.buf[i].rbp)
+                    expr_op(ctx, entry->rbp)
                 );
             } else {
                 args = left;
@@ -568,6 +576,7 @@ static struct Expr expr_op_right(
 
             return Expr_call(ctx->alloc, ctx->intern, name, args);
         }
+    }
         __attribute__((fallthrough));
     case TK_OpenParen:
     case TK_Number:
@@ -586,24 +595,24 @@ static struct Expr expr_op_right(
 static struct Expr expr_parenthesised(struct Context* ctx) {
     assert(Tokenstream_drop_kind(&ctx->toks, TK_OpenParen));
     struct Expr out;
-    if (Tokenstream_peek(&ctx->toks).kind != TK_CloseParen) {
+    if (Tokenstream_peek_kind(&ctx->toks) != TK_CloseParen) {
         out = expr_any(ctx);
 
-        if (Tokenstream_peek(&ctx->toks).kind == TK_Semicolon) {
+        if (Tokenstream_peek_kind(&ctx->toks) == TK_Semicolon) {
             assert(Tokenstream_drop(&ctx->toks));
-            int n = Tokenstream_peek(&ctx->toks).number;
+            int n = Literal_int(Tokenstream_peek(&ctx->toks).number);
             assert(Tokenstream_drop_kind(&ctx->toks, TK_Number));
             struct Expr expr = out;
             for (int i = 1; i < n; i++) 
                 out = Expr_tuple_extend(ctx->alloc, ctx->intern, out, expr);
         }
 
-        while (Tokenstream_peek(&ctx->toks).kind == TK_Comma) {
+        while (Tokenstream_peek_kind(&ctx->toks) == TK_Comma) {
             assert(Tokenstream_drop(&ctx->toks));
             struct Expr next = expr_any(ctx);
-            if (Tokenstream_peek(&ctx->toks).kind == TK_Semicolon) {
+            if (Tokenstream_peek_kind(&ctx->toks) == TK_Semicolon) {
                 assert(Tokenstream_drop(&ctx->toks));
-                int n = Tokenstream_peek(&ctx->toks).number;
+                int n = Literal_int(Tokenstream_peek(&ctx->toks).number);
                 assert(Tokenstream_drop_kind(&ctx->toks, TK_Number));
                 for (int i = 1; i < n; i++)
                     out = Expr_tuple_extend(ctx->alloc, ctx->intern, out, next);
@@ -624,31 +633,32 @@ static struct Expr expr_atom(struct Context *ctx) {
             return expr_parenthesised(ctx);
         case TK_Name:
             assert(Tokenstream_drop(&ctx->toks));
-            return Expr_recall(ctx->intern, peek.spelling);
+            return Expr_recall(ctx->intern, peek.spelling, peek.sym);
         case TK_Number:
             assert(Tokenstream_drop(&ctx->toks));
-            return Expr_number(ctx->intern, peek.spelling);
+            return Expr_number(
+                ctx->intern, peek.spelling, peek.sym,
+                Literals_push(ctx->literals, peek.number)
+            );
         case TK_String:
             assert(Tokenstream_drop(&ctx->toks));
-            return Expr_string(ctx->intern, peek.spelling);
+            return Expr_string(ctx->intern, peek.spelling, peek.sym);
         case TK_Bool:
             assert(Tokenstream_drop(&ctx->toks));
-            return Expr_bool(ctx->intern, peek.spelling);
+            return Expr_bool(ctx->intern, peek.spelling, peek.sym);
         default:
             assert(false && "unexpected token");
     }
 }
 
 static struct Expr statement(struct Context *ctx) {
-    switch (Tokenstream_peek(&ctx->toks).kind) {
+    switch (Tokenstream_peek_kind(&ctx->toks)) {
         case TK_Let: return statement_let(ctx);
         case TK_Mut: return statement_mut(ctx);
         case TK_Break: return statement_break(ctx);
         case TK_Return: return statement_return(ctx);
         case TK_Name: {
-            struct Tokenstream tmp = ctx->toks;
-            assert(Tokenstream_drop(&tmp));
-            if (Tokenstream_peek(&tmp).kind == TK_Equals) {
+            if (Tokenstream_peek_kind_at(&ctx->toks, 1) == TK_Equals) {
                 return statement_assign(ctx);
             }
             __attribute__((fallthrough));
@@ -676,7 +686,7 @@ static struct Expr statement_mut(struct Context *ctx) {
 static struct Expr statement_break(struct Context *ctx) {
     struct Expr expr;
     assert(Tokenstream_drop_kind(&ctx->toks, TK_Break));
-    if (Tokenstream_peek(&ctx->toks).kind != TK_Semicolon) {
+    if (Tokenstream_peek_kind(&ctx->toks) != TK_Semicolon) {
         expr = expr_any(ctx);
     } else {
         expr = Expr_unit(ctx->intern);
@@ -687,7 +697,7 @@ static struct Expr statement_break(struct Context *ctx) {
 static struct Expr statement_return(struct Context *ctx) {
     struct Expr expr;
     assert(Tokenstream_drop_kind(&ctx->toks, TK_Return));
-    if (Tokenstream_peek(&ctx->toks).kind != TK_Semicolon) {
+    if (Tokenstream_peek_kind(&ctx->toks) != TK_Semicolon) {
         expr = expr_any(ctx);
     } else {
         expr = Expr_unit(ctx->intern);
@@ -696,9 +706,9 @@ static struct Expr statement_return(struct Context *ctx) {
 }
 
 static struct Expr statement_assign(struct Context *ctx) {
-    struct String name = Tokenstream_peek(&ctx->toks).spelling;
+    struct Token name = Tokenstream_peek(&ctx->toks);
     assert(Tokenstream_drop_kind(&ctx->toks, TK_Name));
     assert(Tokenstream_drop_kind(&ctx->toks, TK_Equals));
     struct Expr expr = expr_any(ctx);
-    return Expr_assign(ctx->alloc, ctx->intern, name, expr);
+    return Expr_assign(ctx->alloc, ctx->intern, name.spelling, name.sym, expr);
 }
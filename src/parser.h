@@ -5,6 +5,7 @@
 #include <stdbool.h>
 
 #include "./lexer.h"
+#include "./literals.h"
 #include "./strings.h"
 #include "./tokens.h"
 #include "serene.h"
@@ -24,7 +25,18 @@ void PTData_print(void*);
 struct MTree* parse(
     struct serene_Trea*,
     struct Symbols*,
+    struct Literals*,
     struct MTree*
 );
 
+// a single module, its imports only have to be through preimport;
+// data has to stay around until it's parsed and then parse_cleanup'ed
+struct PTData* parse_module(
+    struct serene_Trea*,
+    struct Symbols*,
+    struct Literals*,
+    struct PPData*
+);
+void parse_cleanup(struct PPData*);
+
 #endif
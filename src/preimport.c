@@ -6,7 +6,7 @@
 
 void PPData_print(void* _data) {
     struct PPData* data = _data;
-    printf("PPD{ tokens * %zu, ops * %zu, ... }", data->toks.len, data->ops.len);
+    printf("PPD{ tokens * %zu, ops * %zu, ... }", data->toks.len, data->ops.count);
 }
 
 static struct PPImport resolve_import(struct PIImport* import, struct MTree* root) {
@@ -33,7 +33,8 @@ static void preimport_row(struct serene_Trea* alloc, struct MTree* row) {
         assert(new && "OOM"), ZERO(*new);
         new->closure_status = CS_TODO;
         new->toks = data->toks;
-        new->ops = data->ops;
+        new->file = data->file;
+        new->decls = data->ops;
         for (ll_iter(import, data->imports)) {
             struct PPImports* tmp = serene_trealloc(alloc, struct PPImports);
             assert(tmp && "OOM"), ZERO(*tmp);
@@ -47,7 +48,7 @@ static void preimport_row(struct serene_Trea* alloc, struct MTree* row) {
 }
 static void closure(struct serene_Trea*, struct PPData*);
 
-static struct Opdecls* get_closure(struct serene_Trea* alloc, struct MTree* mod) {
+static struct Optable* get_closure(struct serene_Trea* alloc, struct MTree* mod) {
     struct PPData* data = mod->data;
     if (!data) return NULL;
     switch (data->closure_status) {
@@ -64,12 +65,27 @@ static struct Opdecls* get_closure(struct serene_Trea* alloc, struct MTree* mod)
 static void closure(struct serene_Trea* alloc, struct PPData* data) {
     if (!data) return;
     data->closure_status = CS_WIP;
-    for (ll_iter(head, data->imports)) {
-        struct Opdecls* closure = get_closure(alloc, head->current.mod);
-        if (!closure) continue;
-        for (size_t i = 0; i < closure->len; i++) {
-            assert(Opdecls_push(&data->ops, closure->buf[i]));
-        }
+    size_t len = 0;
+    for (ll_iter(head, data->imports)) len++;
+    const struct Optable* imported[len + 1];
+    size_t i = 0;
+    for (ll_iter(head, data->imports)) imported[i++] = get_closure(alloc, head->current.mod);
+    preimport_closure(alloc, data, imported);
+}
+
+void preimport_closure(
+    struct serene_Trea* alloc,
+    struct PPData* data,
+    const struct Optable* const* imported
+) {
+    // own declarations come first, then each import's in order
+    for (size_t i = 0; i < data->decls.len; i++) {
+        Optable_declare(&data->ops, alloc, data->decls.buf[i]);
+    }
+    Opdecls_deinit(&data->decls);
+    size_t i = 0;
+    for (ll_iter(head, data->imports), i++) {
+        if (imported[i]) Optable_import(&data->ops, alloc, imported[i]);
     }
     data->closure_status = CS_DONE;
 }
@@ -93,9 +109,15 @@ static void cleanup(void* _data) {
     (void)_data;
 }
 
-struct MTree* preimport(struct serene_Trea* alloc, struct MTree* mods) {
+struct MTree* preimport_resolve(struct serene_Trea* alloc, struct MTree* mods) {
     struct Ctx ctx = {alloc};
     MTree_map_whole(mods, preimport_row_ptr, &ctx);
+    return mods;
+}
+
+struct MTree* preimport(struct serene_Trea* alloc, struct MTree* mods) {
+    struct Ctx ctx = {alloc};
+    preimport_resolve(alloc, mods);
     MTree_map(mods, cleanup, closure_ptr, &ctx);
     return mods;
 }
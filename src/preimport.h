@@ -1,8 +1,9 @@
 #ifndef PREIMPORT_H
 #define PREIMPORT_H
 
-#include "tokenvec.h"
+#include "tokens.h"
 #include "opdeclvec.h"
+#include "optable.h"
 #include "strings.h"
 #include "opscan.h"
 #include "mtree.h"
@@ -18,8 +19,13 @@ struct PPImports {
 };
 
 struct PPData {
-    struct Tokenvec toks;
-    struct Opdecls ops;
+    struct Tokens toks;
+    // see PIData
+    struct MTreeFile* file;
+    // its own declarations, until they're part of ops
+    struct Opdecls decls;
+    // its own operators and those of everything it imports
+    struct Optable ops;
     struct PPImports* imports;
     enum { CS_TODO, CS_WIP, CS_DONE } closure_status;
 };
@@ -27,4 +33,15 @@ struct PPData {
 void PPData_print(void*);
 struct MTree* preimport(struct serene_Trea*, struct MTree*);
 
+// just the first half of preimport, swaps in PPData with the imports
+// resolved, leaving the closures for preimport_closure
+struct MTree* preimport_resolve(struct serene_Trea*, struct MTree*);
+// the closure of a single module, imported holds the tables of
+// its imports in the order of data->imports, NULL where there's none
+void preimport_closure(
+    struct serene_Trea*,
+    struct PPData*,
+    const struct Optable* const* imported
+);
+
 #endif
@@ -0,0 +1,208 @@
+#include "sched.h"
+#include "common_ll.h"
+#include "commons.h"
+#include "parser.h"
+#include "preimport.h"
+#include "typer.h"
+#include "workers.h"
+
+#include <assert.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+struct SchedCtx;
+
+struct SchedModule {
+    struct SchedCtx* ctx;
+    struct MTree* node;
+    struct PPData* data;
+    struct serene_Trea* alloc;
+    // the module of each import, in the order of data->imports,
+    // SIZE_MAX where it isn't one
+    size_t* imports;
+    size_t imports_len;
+    // the modules importing this one, once for each import
+    size_t* users;
+    size_t users_len;
+    // imports that aren't through yet, whoever takes it to 0 submits it
+    _Atomic size_t waiting;
+    struct serene_Stats module_stats;
+    struct serene_Stats typer_stats;
+};
+
+struct SchedCtx {
+    struct SchedModule* modules;
+    size_t len;
+    struct Symbols* symbols;
+    struct Literals* literals;
+    struct Workers pool;
+};
+
+struct SchedNode {
+    struct MTree* node;
+    size_t idx;
+};
+
+static int sched_node_cmp(const void* _lhs, const void* _rhs) {
+    const struct SchedNode* lhs = _lhs;
+    const struct SchedNode* rhs = _rhs;
+    return (lhs->node > rhs->node) - (lhs->node < rhs->node);
+}
+
+// the nodes with a module, in the order MTree_map visits them
+static size_t collect_modules(struct MTree* this, struct SchedNode* out, size_t len) {
+    for (size_t i = 0; i < this->subs_count; i++) {
+        len = collect_modules(&this->subs[i], out, len);
+    }
+    if (this->data && out) out[len] = (struct SchedNode){this, len};
+    return this->data ? len + 1 : len;
+}
+
+static void schedule_module(void* _this, unsigned worker) {
+    (void) worker;
+    struct SchedModule* this = _this;
+    struct SchedCtx* ctx = this->ctx;
+
+    const struct Optable* imported[this->imports_len + 1];
+    for (size_t i = 0; i < this->imports_len; i++) {
+        size_t import = this->imports[i];
+        imported[i] = import == SIZE_MAX ? NULL : &ctx->modules[import].data->ops;
+    }
+    preimport_closure(this->alloc, this->data, imported);
+    // the importers only look at the PTData, and only once this is done
+    struct PTData* parsed = parse_module(this->alloc, ctx->symbols, ctx->literals, this->data);
+    this->node->data = parsed;
+    typecheck_module(parsed, &this->typer_stats);
+
+    for (size_t i = 0; i < this->users_len; i++) {
+        struct SchedModule* user = &ctx->modules[this->users[i]];
+        if (atomic_fetch_sub(&user->waiting, 1) == 1) {
+            Workers_submit(&ctx->pool, (struct WorkersTask){schedule_module, user});
+        }
+    }
+}
+
+// the number of waves, where each module is in the one after the last
+// of its imports, asserts there's no cycle along the way
+static size_t schedule_waves(struct serene_Trea* alloc, struct SchedCtx* ctx) {
+    size_t* waiting = serene_trenalloc(alloc, ctx->len, size_t);
+    size_t* waves = serene_trenalloc(alloc, ctx->len, size_t);
+    size_t* ready = serene_trenalloc(alloc, ctx->len, size_t);
+    assert(waiting && waves && ready && "OOM");
+    size_t ready_len = 0;
+    for (size_t i = 0; i < ctx->len; i++) {
+        waiting[i] = ctx->modules[i].waiting;
+        waves[i] = 1;
+        if (waiting[i] == 0) ready[ready_len++] = i;
+    }
+    size_t out = 0;
+    for (size_t done = 0; done < ready_len; done++) {
+        struct SchedModule* module = &ctx->modules[ready[done]];
+        if (waves[ready[done]] > out) out = waves[ready[done]];
+        for (size_t i = 0; i < module->users_len; i++) {
+            size_t user = module->users[i];
+            if (waves[user] < waves[ready[done]] + 1) waves[user] = waves[ready[done]] + 1;
+            if (--waiting[user] == 0) ready[ready_len++] = user;
+        }
+    }
+    assert(ready_len == ctx->len && "Import cycle!!!!");
+    return out;
+}
+
+struct MTree* schedule(
+    struct Schedule* out,
+    struct serene_Trea* alloc,
+    struct serene_Allocator backing,
+    struct Symbols* symbols,
+    struct Literals* literals,
+    struct MTree* mods,
+    unsigned jobs,
+    struct serene_Stats* module_stats,
+    struct serene_Stats* typer_stats
+) {
+    preimport_resolve(alloc, mods);
+    struct SchedCtx ctx = {
+        .len = collect_modules(mods, NULL, 0),
+        .symbols = symbols,
+        .literals = literals,
+    };
+    struct SchedNode* nodes = serene_trenalloc(alloc, ctx.len, struct SchedNode);
+    ctx.modules = serene_trenalloc(alloc, ctx.len, struct SchedModule);
+    struct serene_Trea* allocs = serene_trenalloc(alloc, ctx.len, struct serene_Trea);
+    assert(nodes && ctx.modules && allocs && "OOM");
+    collect_modules(mods, nodes, 0);
+    for (size_t i = 0; i < ctx.len; i++) {
+        struct SchedModule* module = &ctx.modules[i];
+        *module = (struct SchedModule){
+            .ctx = &ctx,
+            .node = nodes[i].node,
+            .data = nodes[i].node->data,
+            .alloc = &allocs[i],
+        };
+        allocs[i] = serene_Trea_init(backing);
+        serene_Trea_track(&allocs[i], &module->module_stats);
+    }
+    // sorted by node, so imports can be looked up
+    qsort(nodes, ctx.len, sizeof(*nodes), sched_node_cmp);
+
+    for (size_t i = 0; i < ctx.len; i++) {
+        struct SchedModule* module = &ctx.modules[i];
+        for (ll_iter(import, module->data->imports)) module->imports_len++;
+        module->imports = serene_trenalloc(alloc, module->imports_len, size_t);
+        assert(module->imports && "OOM");
+        size_t at = 0;
+        for (ll_iter(import, module->data->imports), at++) {
+            struct SchedNode key = {import->current.mod, 0};
+            struct SchedNode* found = bsearch(&key, nodes, ctx.len, sizeof(*nodes), sched_node_cmp);
+            module->imports[at] = found ? found->idx : SIZE_MAX;
+            if (found) ctx.modules[found->idx].users_len++;
+            if (found) module->waiting++;
+        }
+    }
+    for (size_t i = 0; i < ctx.len; i++) {
+        struct SchedModule* module = &ctx.modules[i];
+        module->users = serene_trenalloc(alloc, module->users_len, size_t);
+        assert(module->users && "OOM");
+        module->users_len = 0;
+    }
+    for (size_t i = 0; i < ctx.len; i++) {
+        struct SchedModule* module = &ctx.modules[i];
+        for (size_t j = 0; j < module->imports_len; j++) {
+            if (module->imports[j] == SIZE_MAX) continue;
+            struct SchedModule* import = &ctx.modules[module->imports[j]];
+            import->users[import->users_len++] = i;
+        }
+    }
+    size_t waves = schedule_waves(alloc, &ctx);
+
+    // picked out before any of them run, once they do the counts
+    // of the others drop and those get submitted by the workers
+    size_t* roots = serene_trenalloc(alloc, ctx.len, size_t);
+    assert(roots && "OOM");
+    size_t roots_len = 0;
+    for (size_t i = 0; i < ctx.len; i++) {
+        if (ctx.modules[i].waiting == 0) roots[roots_len++] = i;
+    }
+    Workers_init(&ctx.pool, serene_Libc_dyn(), jobs);
+    for (size_t i = 0; i < roots_len; i++) {
+        Workers_submit(&ctx.pool, (struct WorkersTask){schedule_module, &ctx.modules[roots[i]]});
+    }
+    Workers_wait(&ctx.pool);
+    Workers_deinit(&ctx.pool);
+
+    for (size_t i = 0; i < ctx.len; i++) {
+        struct SchedModule* module = &ctx.modules[i];
+        parse_cleanup(module->data);
+        // all of them are held until the end
+        if (module_stats) serene_Stats_merge(module_stats, module->module_stats);
+        if (typer_stats) serene_Stats_merge(typer_stats, module->typer_stats);
+    }
+    *out = (struct Schedule){.allocs = allocs, .len = ctx.len, .waves = waves};
+    return mods;
+}
+
+void Schedule_deinit(struct Schedule* this) {
+    for (size_t i = 0; i < this->len; i++) serene_Trea_deinit(this->allocs[i]);
+    *this = (struct Schedule){0};
+}
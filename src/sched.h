@@ -0,0 +1,37 @@
+#ifndef SCHED_H
+#define SCHED_H
+
+#include "literals.h"
+#include "mtree.h"
+#include "serene.h"
+#include "symbols.h"
+
+// what a scheduled run leaves behind, every module gets a Trea of its own
+// so that they can be worked on at once, these hold the syntax trees
+// and types of the modules so they have to outlive codegen
+struct Schedule {
+    struct serene_Trea* allocs;
+    size_t len;
+    // the number of modules along the longest chain of imports
+    size_t waves;
+};
+
+// preimport, parse and typecheck, with each module going through all
+// three on one of jobs workers as soon as everything it imports has;
+// alloc is only used from this thread, backing is shared by the modules'
+// Treas so it has to be safe to share, and the allocations of the modules
+// and the typer get added up into the stats, which may be NULL
+struct MTree* schedule(
+    struct Schedule*,
+    struct serene_Trea* alloc,
+    struct serene_Allocator backing,
+    struct Symbols*,
+    struct Literals*,
+    struct MTree*,
+    unsigned jobs,
+    struct serene_Stats* module_stats,
+    struct serene_Stats* typer_stats
+);
+void Schedule_deinit(struct Schedule*);
+
+#endif
@@ -2,6 +2,8 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
 
 void *serene_align(void *ptr, size_t align) {
     uintptr_t hangover = ((uintptr_t) ptr) % align;
@@ -9,9 +11,27 @@ void *serene_align(void *ptr, size_t align) {
     return ptr + (align - ((uintptr_t) ptr) % align);
 }
 
+void *serene_moving_resize(
+    struct serene_Allocator a,
+    void *ptr,
+    struct serene_Ptrmeta meta,
+    size_t size
+) {
+    void *out = a.alloc(a.ctx, (struct serene_Ptrmeta) {size, meta.align});
+    if (!out) return NULL;
+    if (ptr) {
+        memcpy(out, ptr, meta.size < size ? meta.size : size);
+        a.free(a.ctx, ptr, meta);
+    }
+    return out;
+}
+
 struct serene_Allocator serene_Arena_dyn(struct serene_Arena *this) {
     return (struct serene_Allocator) {
-        .ctx = this, .alloc = serene_Arena_alloc, .free = serene_Arena_free,
+        .ctx = this,
+        .alloc = serene_Arena_alloc,
+        .free = serene_Arena_free,
+        .resize = serene_Arena_resize,
     };
 }
 
@@ -48,6 +68,38 @@ void serene_Arena_free(void *this_, void *ptr, struct serene_Ptrmeta meta) {
     return;
 }
 
+void *serene_Arena_resize(
+    void *this_,
+    void *ptr,
+    struct serene_Ptrmeta meta,
+    size_t size
+) {
+    struct serene_Arena *this = this_;
+    // the newest allocation can grow or shrink where it is
+    if (ptr && this->bump == (char *) ptr + meta.size
+        && (char *) ptr + size <= this->segments->cap) {
+        this->bump = (char *) ptr + size;
+        return ptr;
+    }
+    return serene_moving_resize(serene_Arena_dyn(this), ptr, meta, size);
+}
+
+struct serene_ArenaMark serene_Arena_mark(struct serene_Arena *this) {
+    return (struct serene_ArenaMark) {
+        .segment = this->segments,
+        .bump = this->bump,
+    };
+}
+
+void serene_Arena_reset(struct serene_Arena *this, struct serene_ArenaMark mark) {
+    while (this->segments != mark.segment) {
+        struct serene_ArenaLL *head = this->segments;
+        this->segments = head->next;
+        serene_tfree(this->backing, head->cap - head->buf, head);
+    }
+    this->bump = mark.bump;
+}
+
 void serene_Arena_deinit(struct serene_Arena *this) {
     struct serene_ArenaLL *next = this->segments;
     while (next) {
@@ -57,11 +109,112 @@ void serene_Arena_deinit(struct serene_Arena *this) {
     }
 }
 
+// commits happen in huge page sized steps
+#define Mmap_chunk ((size_t) 2 * 1024 * 1024)
+
+struct serene_Mmap serene_Mmap_init(size_t reserve) {
+    if (reserve < Mmap_chunk) reserve = Mmap_chunk;
+    return (struct serene_Mmap) {.reserve = reserve};
+}
+
+struct serene_Allocator serene_Mmap_dyn(struct serene_Mmap *this) {
+    return (struct serene_Allocator) {
+        .ctx = this,
+        .alloc = serene_Mmap_alloc,
+        .free = serene_Mmap_free,
+        .resize = serene_Mmap_resize,
+    };
+}
+
+static bool Mmap_new_range(struct serene_Mmap *this, size_t min) {
+    size_t size = this->reserve;
+    min += sizeof(struct serene_MmapRange);
+    if (size < min) size = (min + Mmap_chunk - 1) / Mmap_chunk * Mmap_chunk;
+    // over-reserve by a chunk so the range can start huge page aligned
+    char *raw = mmap(
+        NULL, size + Mmap_chunk, PROT_NONE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0
+    );
+    if (raw == MAP_FAILED) return false;
+    char *start = serene_align(raw, Mmap_chunk);
+    if (start != raw) munmap(raw, start - raw);
+    munmap(start + size, raw + Mmap_chunk - start);
+#ifdef MADV_HUGEPAGE
+    madvise(start, size, MADV_HUGEPAGE);
+#endif
+    if (mprotect(start, Mmap_chunk, PROT_READ | PROT_WRITE) != 0) {
+        munmap(start, size);
+        return false;
+    }
+    struct serene_MmapRange *range = (void *) start;
+    range->prev = this->range;
+    range->committed = start + Mmap_chunk;
+    range->end = start + size;
+    this->range = range;
+    this->bump = start + sizeof(struct serene_MmapRange);
+    return true;
+}
+
+static bool Mmap_commit(struct serene_Mmap *this, char *upto) {
+    struct serene_MmapRange *range = this->range;
+    if (upto <= range->committed) return true;
+    char *want = serene_align(upto, Mmap_chunk);
+    if (want > range->end) want = range->end;
+    if (mprotect(
+        range->committed, want - range->committed, PROT_READ | PROT_WRITE
+    ) != 0) return false;
+    range->committed = want;
+    return true;
+}
+
+void *serene_Mmap_alloc(void *this_, struct serene_Ptrmeta meta) {
+    struct serene_Mmap *this = this_;
+    char *out = this->range ? serene_align(this->bump, meta.align) : NULL;
+    if (!out || out + meta.size > this->range->end) {
+        if (!Mmap_new_range(this, meta.size + meta.align)) return NULL;
+        out = serene_align(this->bump, meta.align);
+    }
+    if (!Mmap_commit(this, out + meta.size)) return NULL;
+    this->bump = out + meta.size;
+    return out;
+}
+
+void serene_Mmap_free(void *this_, void *ptr, struct serene_Ptrmeta meta) {
+    struct serene_Mmap *this = this_;
+    if (ptr && this->bump == (char *) ptr + meta.size) this->bump = ptr;
+}
+
+void *serene_Mmap_resize(
+    void *this_,
+    void *ptr,
+    struct serene_Ptrmeta meta,
+    size_t size
+) {
+    struct serene_Mmap *this = this_;
+    if (ptr && this->bump == (char *) ptr + meta.size
+        && (char *) ptr + size <= this->range->end
+        && Mmap_commit(this, (char *) ptr + size)) {
+        this->bump = (char *) ptr + size;
+        return ptr;
+    }
+    return serene_moving_resize(serene_Mmap_dyn(this), ptr, meta, size);
+}
+
+void serene_Mmap_deinit(struct serene_Mmap *this) {
+    while (this->range) {
+        struct serene_MmapRange *range = this->range;
+        this->range = range->prev;
+        munmap(range, range->end - (char *) range);
+    }
+    this->bump = NULL;
+}
+
 struct serene_Allocator serene_Libc_dyn() {
     return (struct serene_Allocator){
         .ctx = NULL,
         .alloc = serene_Libc_alloc,
         .free = serene_Libc_free,
+        .resize = serene_Libc_resize,
     };
 }
 void *serene_Libc_alloc(void *ctx, struct serene_Ptrmeta meta) {
@@ -73,49 +226,365 @@ void serene_Libc_free(void *ctx, void *ptr, struct serene_Ptrmeta meta) {
     (void)ctx;
     free(ptr);
 }
+void *serene_Libc_resize(
+    void *ctx,
+    void *ptr,
+    struct serene_Ptrmeta meta,
+    size_t size
+) {
+    (void)ctx;
+    (void)meta;
+    return realloc(ptr, size);
+}
+
+void serene_Stats_merge(struct serene_Stats* into, struct serene_Stats from) {
+    into->requested += from.requested;
+    into->padding += from.padding;
+    into->blocks += from.blocks;
+    into->live += from.live;
+    // they peak at different times, so adding those up means nothing;
+    // what's live at the end was live at once though
+    if (from.peak > into->peak) into->peak = from.peak;
+    if (into->live > into->peak) into->peak = into->live;
+}
+
+struct serene_Allocator serene_Tracer_dyn(struct serene_Tracer* this) {
+    return (struct serene_Allocator) {
+        .ctx = this,
+        .alloc = serene_Tracer_alloc,
+        .free = serene_Tracer_free,
+        .resize = serene_Tracer_resize,
+    };
+}
+
+static void Tracer_live(struct serene_Stats* stats, size_t add, size_t sub) {
+    stats->live += add;
+    stats->live -= sub;
+    if (stats->live > stats->peak) stats->peak = stats->live;
+}
+
+void* serene_Tracer_alloc(void* this_, struct serene_Ptrmeta meta) {
+    struct serene_Tracer* this = this_;
+    void* out = this->backing.alloc(this->backing.ctx, meta);
+    if (!out) return NULL;
+    this->stats.requested += meta.size;
+    this->stats.blocks++;
+    Tracer_live(&this->stats, meta.size, 0);
+    return out;
+}
+
+void serene_Tracer_free(void* this_, void* ptr, struct serene_Ptrmeta meta) {
+    struct serene_Tracer* this = this_;
+    if (!ptr) return;
+    this->backing.free(this->backing.ctx, ptr, meta);
+    Tracer_live(&this->stats, 0, meta.size);
+}
+
+void* serene_Tracer_resize(
+    void* this_,
+    void* ptr,
+    struct serene_Ptrmeta meta,
+    size_t size
+) {
+    struct serene_Tracer* this = this_;
+    if (!ptr) return serene_Tracer_alloc(this, (struct serene_Ptrmeta) {size, meta.align});
+    void* out = this->backing.resize(this->backing.ctx, ptr, meta, size);
+    if (!out) return NULL;
+    if (size > meta.size) this->stats.requested += size - meta.size;
+    Tracer_live(&this->stats, size, meta.size);
+    return out;
+}
+
+struct serene_Locked serene_Locked_init(struct serene_Allocator backing) {
+    // statically initialized, so it's fine to copy until first use
+    return (struct serene_Locked) {
+        .backing = backing,
+        .lock = PTHREAD_MUTEX_INITIALIZER,
+    };
+}
+
+struct serene_Allocator serene_Locked_dyn(struct serene_Locked* this) {
+    return (struct serene_Allocator) {
+        .ctx = this,
+        .alloc = serene_Locked_alloc,
+        .free = serene_Locked_free,
+        .resize = serene_Locked_resize,
+    };
+}
+
+void* serene_Locked_alloc(void* this_, struct serene_Ptrmeta meta) {
+    struct serene_Locked* this = this_;
+    pthread_mutex_lock(&this->lock);
+    void* out = this->backing.alloc(this->backing.ctx, meta);
+    pthread_mutex_unlock(&this->lock);
+    return out;
+}
+
+void serene_Locked_free(void* this_, void* ptr, struct serene_Ptrmeta meta) {
+    struct serene_Locked* this = this_;
+    pthread_mutex_lock(&this->lock);
+    this->backing.free(this->backing.ctx, ptr, meta);
+    pthread_mutex_unlock(&this->lock);
+}
+
+void* serene_Locked_resize(
+    void* this_,
+    void* ptr,
+    struct serene_Ptrmeta meta,
+    size_t size
+) {
+    struct serene_Locked* this = this_;
+    pthread_mutex_lock(&this->lock);
+    void* out = this->backing.resize(this->backing.ctx, ptr, meta, size);
+    pthread_mutex_unlock(&this->lock);
+    return out;
+}
+
+void serene_Locked_deinit(struct serene_Locked* this) {
+    pthread_mutex_destroy(&this->lock);
+}
+
+struct serene_Allocator serene_Pool_dyn(struct serene_Pool* this) {
+    return (struct serene_Allocator) {
+        .ctx = this,
+        .alloc = serene_Pool_alloc,
+        .free = serene_Pool_free,
+        .resize = serene_Pool_resize,
+    };
+}
+
+struct serene_Pool serene_Pool_init(struct serene_Allocator backing) {
+    return (struct serene_Pool) {.backing = backing};
+}
+
+static bool Pool_class(struct serene_Ptrmeta meta, size_t* class) {
+    if (meta.size == 0 || meta.align > serene_Pool_step) return false;
+    *class = (meta.size - 1) / serene_Pool_step;
+    return *class < serene_Pool_classes;
+}
+
+void* serene_Pool_alloc(void* this_, struct serene_Ptrmeta meta) {
+    struct serene_Pool* this = this_;
+    size_t class;
+    if (!Pool_class(meta, &class)) return this->backing.alloc(this->backing.ctx, meta);
+
+    if (!this->free[class]) {
+        // carve a fresh slab into nodes of this class
+        size_t bufsz = serene_Pool_slab_size - sizeof(struct serene_PoolSlab);
+        struct serene_PoolSlab* slab =
+            serene_talloc(this->backing, bufsz, struct serene_PoolSlab);
+        if (!slab) return NULL;
+        slab->next = this->slabs;
+        this->slabs = slab;
+        size_t node_size = (class + 1) * serene_Pool_step;
+        for (size_t i = bufsz / node_size; i > 0; i--) {
+            struct serene_PoolNode* node = (void*) &slab->buf[(i - 1) * node_size];
+            node->next = this->free[class];
+            this->free[class] = node;
+        }
+    }
+    struct serene_PoolNode* out = this->free[class];
+    this->free[class] = out->next;
+    return out;
+}
+
+void serene_Pool_free(void* this_, void* ptr, struct serene_Ptrmeta meta) {
+    struct serene_Pool* this = this_;
+    if (!ptr) return;
+    size_t class;
+    if (!Pool_class(meta, &class)) {
+        this->backing.free(this->backing.ctx, ptr, meta);
+        return;
+    }
+    struct serene_PoolNode* node = ptr;
+    node->next = this->free[class];
+    this->free[class] = node;
+}
+
+void* serene_Pool_resize(
+    void* this,
+    void* ptr,
+    struct serene_Ptrmeta meta,
+    size_t size
+) {
+    size_t old_class, new_class;
+    struct serene_Ptrmeta new_meta = {size, meta.align};
+    if (ptr && Pool_class(meta, &old_class)
+        && Pool_class(new_meta, &new_class) && old_class == new_class) {
+        return ptr;
+    }
+    return serene_moving_resize(serene_Pool_dyn(this), ptr, meta, size);
+}
+
+void serene_Pool_deinit(struct serene_Pool* this) {
+    size_t bufsz = serene_Pool_slab_size - sizeof(struct serene_PoolSlab);
+    struct serene_PoolSlab* next = this->slabs;
+    while (next) {
+        struct serene_PoolSlab* head = next;
+        next = head->next;
+        serene_tfree(this->backing, bufsz, head);
+    }
+    *this = (struct serene_Pool) {.backing = this->backing};
+}
 
 struct serene_Allocator serene_Trea_dyn(struct serene_Trea* this) {
     return (struct serene_Allocator) {
         .ctx = this,
         .alloc = serene_Trea_dyn_alloc,
         .free = serene_Trea_dyn_free,
+        .resize = serene_Trea_dyn_resize,
     };
 }
 
 struct Trea_Header {
     struct serene_Trea_Sub *next;
     struct serene_Trea_Sub *prev;
-    uint16_t bump;
+    uint32_t bump;
+    uint32_t cap;
+    // order of creation, lets a reset tell which blocks came after its mark
+    uint32_t stamp;
     uint16_t gen;
 };
 
-#define Trea_Sub_bufsz (4096 - sizeof(struct Trea_Header))
-
 struct serene_Trea_Sub {
     struct Trea_Header meta;
-    uint8_t buf[Trea_Sub_bufsz];
+    alignas(max_align_t) uint8_t buf[];
+};
+
+struct serene_Trea_Bin {
+    struct serene_Trea_Sub* blocks;
+    size_t block_size;
+    uint32_t stamp;
 };
 
+#define Trea_bufsz(block_size) ((block_size) - sizeof(struct serene_Trea_Sub))
+
+static void Trea_count(struct serene_Stats* stats, size_t cap, bool taken) {
+    if (!stats) return;
+    size_t size = sizeof(struct serene_Trea_Sub) + cap;
+    if (taken) {
+        stats->blocks++;
+        stats->live += size;
+        if (stats->live > stats->peak) stats->peak = stats->live;
+    } else {
+        stats->live -= size;
+    }
+}
+
+static struct serene_Trea_Sub* Trea_block(
+    struct serene_Allocator backing,
+    struct serene_Trea_Bin* bin,
+    struct serene_Stats* stats,
+    size_t cap
+) {
+    struct serene_Trea_Sub* block = NULL;
+    if (bin && Trea_bufsz(bin->block_size) == cap && bin->blocks) {
+        block = bin->blocks;
+        bin->blocks = block->meta.next;
+    } else {
+        block = serene_talloc(backing, cap, struct serene_Trea_Sub);
+    }
+    if (!block) return NULL;
+    block->meta = (struct Trea_Header) {.cap = (uint32_t) cap};
+    Trea_count(stats, cap, true);
+    return block;
+}
+
+static void Trea_release(
+    struct serene_Allocator backing,
+    struct serene_Trea_Bin* bin,
+    struct serene_Stats* stats,
+    struct serene_Trea_Sub* block
+) {
+    Trea_count(stats, block->meta.cap, false);
+    // only blocks of the root's size go back in the bin,
+    // large objects and odd-sized sub blocks go back to the backing
+    if (bin && Trea_bufsz(bin->block_size) == block->meta.cap) {
+        block->meta.next = bin->blocks;
+        bin->blocks = block;
+    } else {
+        serene_tfree(backing, block->meta.cap, block);
+    }
+}
+
+static uint8_t* Trea_bump(
+    struct serene_Trea_Sub* block,
+    struct serene_Stats* stats,
+    struct serene_Ptrmeta meta
+) {
+    uint8_t* start = serene_align(&block->buf[block->meta.bump], meta.align);
+    if (start + meta.size > &block->buf[block->meta.cap]) return NULL;
+    if (stats) {
+        stats->requested += meta.size;
+        stats->padding += start - &block->buf[block->meta.bump];
+    }
+    block->meta.bump = (uint32_t) (start + meta.size - &block->buf[0]);
+    return start;
+}
+
+// large objects get a block of their own, linked right after
+// current so the free space left in current isn't thrown away
+static void Trea_link_large(struct serene_Trea* this, struct serene_Trea_Sub* block) {
+    struct serene_Trea_Sub* next = this->current->meta.next;
+    block->meta.stamp = ++this->bin->stamp;
+    block->meta.gen = this->current->meta.gen;
+    block->meta.prev = this->current;
+    block->meta.next = next;
+    if (next) next->meta.prev = block;
+    this->current->meta.next = block;
+}
+
+static void Trea_unlink(struct serene_Trea_Sub* block) {
+    if (block->meta.prev) block->meta.prev->meta.next = block->meta.next;
+    if (block->meta.next) block->meta.next->meta.prev = block->meta.prev;
+}
+
+// the block past current that holds ptr and nothing else, if any
+static struct serene_Trea_Sub* Trea_large(
+    struct serene_Trea* this,
+    void* ptr,
+    struct serene_Ptrmeta meta
+) {
+    if (!ptr || meta.size <= Trea_bufsz(this->block_size) / 4) return NULL;
+    uint16_t gen = this->current->meta.gen;
+    for (
+        struct serene_Trea_Sub* head = this->current->meta.next;
+        head && head->meta.gen >= gen;
+        head = head->meta.next
+    ) {
+        if (head->meta.gen != gen) continue;
+        uint8_t* start = serene_align(&head->buf[0], meta.align);
+        if (start == ptr && &head->buf[head->meta.bump] == start + meta.size) return head;
+    }
+    return NULL;
+}
+
 void* serene_Trea_alloc(struct serene_Trea* this, struct serene_Ptrmeta meta) {
     if (!this->current) return NULL;
-    uint8_t* start = &this->current->buf[this->current->meta.bump];
-    start += meta.align;
-    start -= (intptr_t) start % meta.align;
-    uint8_t* end = start + meta.size;
-    if (end >= &this->current->buf[Trea_Sub_bufsz]) {
-        struct serene_Trea_Sub* block = serene_alloc(this->backing, struct serene_Trea_Sub);
+    uint8_t* out = Trea_bump(this->current, this->stats, meta);
+    if (out) return out;
+
+    size_t bufsz = Trea_bufsz(this->block_size);
+    if (meta.size > bufsz / 4) {
+        struct serene_Trea_Sub* block =
+            Trea_block(this->backing, NULL, this->stats, meta.size + meta.align);
         if (!block) return NULL;
-        block->meta.gen = this->current->meta.gen;
-        struct serene_Trea_Sub* prev = this->current->meta.prev;
-        if (prev) prev->meta.next = block;
-        block->meta.prev = prev;
-        block->meta.next = this->current;
-        this->current->meta.prev = block;
-        this->current = block;
-        return serene_Trea_alloc(this, meta);
+        Trea_link_large(this, block);
+        return Trea_bump(block, this->stats, meta);
     }
-    this->current->meta.bump = (uint16_t) (end - &this->current->buf[0]);
-    return (void*) start;
+
+    struct serene_Trea_Sub* block =
+        Trea_block(this->backing, this->bin, this->stats, bufsz);
+    if (!block) return NULL;
+    block->meta.stamp = ++this->bin->stamp;
+    block->meta.gen = this->current->meta.gen;
+    struct serene_Trea_Sub* prev = this->current->meta.prev;
+    if (prev) prev->meta.next = block;
+    block->meta.prev = prev;
+    block->meta.next = this->current;
+    this->current->meta.prev = block;
+    this->current = block;
+    return Trea_bump(block, this->stats, meta);
 }
 
 void* serene_Trea_dyn_alloc(void* this, struct serene_Ptrmeta meta) {
@@ -127,44 +596,182 @@ void serene_Trea_dyn_free(void* this, void* ptr, struct serene_Ptrmeta meta) {
     (void)this; (void)ptr; (void)meta;
 }
 
+void* serene_Trea_resize(
+    struct serene_Trea* this,
+    void* ptr,
+    struct serene_Ptrmeta meta,
+    size_t size
+) {
+    struct serene_Trea_Sub* block = this->current;
+    // the newest allocation in current can grow or shrink where it is
+    if (ptr && block
+        && (uint8_t*) ptr + meta.size == &block->buf[block->meta.bump]
+        && (uint8_t*) ptr + size <= &block->buf[block->meta.cap]) {
+        block->meta.bump = (uint32_t) ((uint8_t*) ptr + size - &block->buf[0]);
+        if (this->stats) this->stats->requested += size - meta.size;
+        return ptr;
+    }
+    if (size <= meta.size) return ptr;
+    if (!block) return NULL;
+
+    // a large object with a block of its own grows with the block,
+    // which then counts as newly allocated
+    struct serene_Trea_Sub* large = Trea_large(this, ptr, meta);
+    if (large && meta.align <= alignof(max_align_t)) {
+        size_t cap = size + meta.align;
+        size_t offset = (uint8_t*) ptr - &large->buf[0];
+        uint32_t old_cap = large->meta.cap;
+        struct serene_Trea_Sub* grown = this->backing.resize(
+            this->backing.ctx,
+            large,
+            serene_tmeta(old_cap, struct serene_Trea_Sub),
+            sizeof(struct serene_Trea_Sub) + cap
+        );
+        if (grown) {
+            // the links moved along with it and still point back at it
+            Trea_unlink(grown);
+            Trea_count(this->stats, old_cap, false);
+            if (this->stats) this->stats->blocks--;
+            Trea_count(this->stats, cap, true);
+            if (this->stats) this->stats->requested += size - meta.size;
+            grown->meta.cap = (uint32_t) cap;
+            grown->meta.bump = (uint32_t) (offset + size);
+            Trea_link_large(this, grown);
+            return &grown->buf[offset];
+        }
+    }
+    void* out = serene_Trea_alloc(this, (struct serene_Ptrmeta) {size, meta.align});
+    if (!out) return NULL;
+    if (ptr) memcpy(out, ptr, meta.size);
+    // nothing else lives in it, so there's no reason to keep it around
+    if (large) {
+        Trea_unlink(large);
+        Trea_release(this->backing, this->bin, this->stats, large);
+    }
+    return out;
+}
+
+void* serene_Trea_dyn_resize(
+    void* this,
+    void* ptr,
+    struct serene_Ptrmeta meta,
+    size_t size
+) {
+    return serene_Trea_resize((struct serene_Trea*)this, ptr, meta, size);
+}
+
 struct serene_Trea serene_Trea_init(struct serene_Allocator backing) {
-    struct serene_Trea_Sub* block = serene_alloc(backing, struct serene_Trea_Sub);
-    block->meta = (struct Trea_Header) {0};
-    return (struct serene_Trea) {
+    return serene_Trea_init_sized(backing, serene_Trea_block_size);
+}
+
+struct serene_Trea serene_Trea_init_sized(
+    struct serene_Allocator backing,
+    size_t block_size
+) {
+    struct serene_Trea_Sub* block =
+        Trea_block(backing, NULL, NULL, Trea_bufsz(block_size));
+    if (!block) return (struct serene_Trea) {0};
+    struct serene_Trea out = {
         .backing = backing,
         .current = block,
+        .block_size = block_size,
+    };
+    // the bin lives in the root's first block,
+    // so it stays put however the Trea gets copied around
+    out.bin = serene_trealloc(&out, struct serene_Trea_Bin);
+    *out.bin = (struct serene_Trea_Bin) {NULL, block_size, 0};
+    return out;
+}
+
+void serene_Trea_track(struct serene_Trea* this, struct serene_Stats* stats) {
+    if (!this->current) return;
+    uint16_t gen = this->current->meta.gen;
+    for (
+        struct serene_Trea_Sub* head = this->current;
+        head && head->meta.gen >= gen;
+        head = head->meta.next
+    ) {
+        Trea_count(this->stats, head->meta.cap, false);
+        if (this->stats) this->stats->blocks--;
+        Trea_count(stats, head->meta.cap, true);
+    }
+    this->stats = stats;
+}
+
+struct serene_TreaMark serene_Trea_mark(struct serene_Trea* this) {
+    if (!this->current) return (struct serene_TreaMark) {0};
+    return (struct serene_TreaMark) {
+        .block = this->current,
+        .bump = this->current->meta.bump,
+        .stamp = this->bin->stamp,
     };
 }
 
+void serene_Trea_reset(struct serene_Trea* this, struct serene_TreaMark mark) {
+    if (!mark.block) return;
+    uint16_t gen = mark.block->meta.gen;
+    struct serene_Trea_Sub* prev = this->current->meta.prev;
+    // blocks grown since the mark sit before the marked one...
+    struct serene_Trea_Sub* head = this->current;
+    while (head != mark.block) {
+        struct serene_Trea_Sub* cur = head;
+        head = head->meta.next;
+        Trea_release(this->backing, this->bin, this->stats, cur);
+    }
+    // ...and large objects get linked in right after it
+    struct serene_Trea_Sub* next = mark.block->meta.next;
+    while (next && next->meta.gen == gen && next->meta.stamp > mark.stamp) {
+        struct serene_Trea_Sub* cur = next;
+        next = next->meta.next;
+        Trea_release(this->backing, this->bin, this->stats, cur);
+    }
+    mark.block->meta.prev = prev;
+    if (prev) prev->meta.next = mark.block;
+    mark.block->meta.next = next;
+    if (next) next->meta.prev = mark.block;
+    mark.block->meta.bump = mark.bump;
+    this->current = mark.block;
+}
+
 void serene_Trea_deinit(struct serene_Trea this) {
-    // doesn't work :KEKW:
-    return;
     if (!this.current) return;
     uint16_t gen = this.current->meta.gen;
+    // the blocks of a Trea and of all its subs form one run starting
+    // at current, the first block after that run has a lower gen
+    struct serene_Trea_Sub* prev = this.current->meta.prev;
     struct serene_Trea_Sub* head = this.current;
-    while (head && head->meta.gen >= gen) {
-        if (head->meta.gen == gen) {
-            struct serene_Trea_Sub* prev = head->meta.prev;
-            struct serene_Trea_Sub* next = head->meta.next;
-            struct serene_Trea_Sub* cur = head;
-            head = next;
-            if (prev != NULL) prev->meta.next = next;
-            if (next != NULL) next->meta.prev = prev;
-            serene_free(this.backing, cur);
-        } else {
-            struct serene_Trea child = {
-                .backing = this.backing,
-                .current = head,
-            };
-            head = head->meta.next;
-            serene_Trea_deinit(child);
+    struct serene_Trea_Bin* bin = this.bin;
+    if (gen == 0) {
+        // the root takes the bin down with it
+        struct serene_Trea_Sub* next = bin->blocks;
+        while (next) {
+            struct serene_Trea_Sub* cur = next;
+            next = cur->meta.next;
+            Trea_release(this.backing, NULL, NULL, cur);
         }
+        bin = NULL;
+    }
+    while (head && head->meta.gen >= gen) {
+        struct serene_Trea_Sub* cur = head;
+        head = head->meta.next;
+        Trea_release(this.backing, bin, this.stats, cur);
     }
+    if (prev) prev->meta.next = head;
+    if (head) head->meta.prev = prev;
 }
 
 struct serene_Trea serene_Trea_sub(struct serene_Trea* root) {
+    return serene_Trea_sub_sized(root, root->block_size);
+}
+
+struct serene_Trea serene_Trea_sub_sized(
+    struct serene_Trea* root,
+    size_t block_size
+) {
     if (!root->current) return (struct serene_Trea) {0};
-    struct serene_Trea_Sub* block = serene_alloc(root->backing, struct serene_Trea_Sub);
+    struct serene_Trea_Sub* block =
+        Trea_block(root->backing, root->bin, root->stats, Trea_bufsz(block_size));
+    if (!block) return (struct serene_Trea) {0};
     struct serene_Trea_Sub* next = root->current->meta.next;
     uint16_t gen = root->current->meta.gen;
     if (next != NULL && next->meta.gen > gen) gen = next->meta.gen;
@@ -177,5 +784,8 @@ struct serene_Trea serene_Trea_sub(struct serene_Trea* root) {
     return (struct serene_Trea) {
         .backing = root->backing,
         .current = block,
+        .bin = root->bin,
+        .block_size = block_size,
+        .stats = root->stats,
     };
 }
@@ -3,6 +3,7 @@
 
 #include <stddef.h>
 #include <stdalign.h>
+#include <pthread.h>
 
 void* serene_align(void*, size_t);
 
@@ -26,6 +27,9 @@ struct serene_Ptrmeta {
 #define serene_nalloc(a, n, T) (T*) a.alloc(a.ctx, serene_nmeta(n, T))
 #define serene_talloc(a, s, T) (T*) a.alloc(a.ctx, serene_tmeta(s, T))
 
+#define serene_nresize(a, p, n, m)                                             \
+    (typeof(p)) a.resize(a.ctx, p, serene_nmeta(n, *p), sizeof(*p) * m)
+
 #define serene_free(a, p) a.free(a.ctx, p, serene_meta(*p))
 #define serene_nfree(a, n, p) a.free(a.ctx, p, serene_nmeta(n, *p))
 #define serene_tfree(a, s, p) a.free(a.ctx, p, serene_tmeta(s, *p))
@@ -34,8 +38,15 @@ struct serene_Allocator {
     void *ctx;
     void *(*alloc)(void *, struct serene_Ptrmeta);
     void (*free)(void *, void *, struct serene_Ptrmeta);
+    // returns NULL and leaves the old allocation alone on failure
+    void *(*resize)(void *, void *, struct serene_Ptrmeta, size_t);
 };
 
+// alloc, copy and free, for when it can't be done in place
+void *serene_moving_resize(
+    struct serene_Allocator, void *, struct serene_Ptrmeta, size_t
+);
+
 struct serene_Arena {
     struct serene_Allocator backing;
     struct serene_ArenaLL {
@@ -49,16 +60,124 @@ struct serene_Arena {
 struct serene_Allocator serene_Arena_dyn(struct serene_Arena *);
 void *serene_Arena_alloc(void *, struct serene_Ptrmeta);
 void serene_Arena_free(void *, void *, struct serene_Ptrmeta);
+void *serene_Arena_resize(void *, void *, struct serene_Ptrmeta, size_t);
 void serene_Arena_deinit(struct serene_Arena *);
 
+// everything allocated after a mark is dropped by resetting to it
+struct serene_ArenaMark {
+    struct serene_ArenaLL *segment;
+    char *bump;
+};
+
+struct serene_ArenaMark serene_Arena_mark(struct serene_Arena *);
+void serene_Arena_reset(struct serene_Arena *, struct serene_ArenaMark);
+
+// bytes asked for, bytes lost to alignment,
+// blocks taken from the backing and how many bytes of them are held
+struct serene_Stats {
+    size_t requested;
+    size_t padding;
+    size_t blocks;
+    size_t live;
+    size_t peak;
+};
+
+// adds from onto into, for allocators that were counted apart,
+// the peak is the larger of the two and at least what's live
+void serene_Stats_merge(struct serene_Stats* into, struct serene_Stats from);
+
+// counts everything that passes through to the backing
+struct serene_Tracer {
+    struct serene_Allocator backing;
+    struct serene_Stats stats;
+};
+
+struct serene_Allocator serene_Tracer_dyn(struct serene_Tracer*);
+void* serene_Tracer_alloc(void*, struct serene_Ptrmeta);
+void serene_Tracer_free(void*, void*, struct serene_Ptrmeta);
+void* serene_Tracer_resize(void*, void*, struct serene_Ptrmeta, size_t);
+
+// serializes everything passing through to the backing,
+// so that allocators on different threads can share it
+struct serene_Locked {
+    struct serene_Allocator backing;
+    pthread_mutex_t lock;
+};
+
+struct serene_Locked serene_Locked_init(struct serene_Allocator backing);
+struct serene_Allocator serene_Locked_dyn(struct serene_Locked*);
+void* serene_Locked_alloc(void*, struct serene_Ptrmeta);
+void serene_Locked_free(void*, void*, struct serene_Ptrmeta);
+void* serene_Locked_resize(void*, void*, struct serene_Ptrmeta, size_t);
+void serene_Locked_deinit(struct serene_Locked*);
+
+// bump allocates out of large reserved address ranges,
+// committing them a chunk at a time as the bump moves on;
+// only the newest allocation can be freed or resized in place
+struct serene_Mmap {
+    struct serene_MmapRange {
+        struct serene_MmapRange *prev;
+        char *committed;
+        char *end;
+    } *range;
+    char *bump;
+    size_t reserve;
+};
+
+struct serene_Mmap serene_Mmap_init(size_t reserve);
+struct serene_Allocator serene_Mmap_dyn(struct serene_Mmap *);
+void *serene_Mmap_alloc(void *, struct serene_Ptrmeta);
+void serene_Mmap_free(void *, void *, struct serene_Ptrmeta);
+void *serene_Mmap_resize(void *, void *, struct serene_Ptrmeta, size_t);
+void serene_Mmap_deinit(struct serene_Mmap *);
+
 struct serene_Allocator serene_Libc_dyn();
 void *serene_Libc_alloc(void *, struct serene_Ptrmeta);
 void serene_Libc_free(void *, void *, struct serene_Ptrmeta);
+void *serene_Libc_resize(void *, void *, struct serene_Ptrmeta, size_t);
+
+// size classes go in steps of 16 bytes up to 256,
+// anything bigger or more aligned is passed on to the backing
+#define serene_Pool_step 16
+#define serene_Pool_classes 16
+#define serene_Pool_slab_size 4096
+
+struct serene_Pool {
+    struct serene_Allocator backing;
+    struct serene_PoolSlab {
+        struct serene_PoolSlab* next;
+        alignas(serene_Pool_step) char buf[];
+    }* slabs;
+    struct serene_PoolNode {
+        struct serene_PoolNode* next;
+    }* free[serene_Pool_classes];
+};
+
+#define serene_poolalloc(a, T) ((T*) serene_Pool_alloc(a, serene_meta(T)))
+#define serene_poolfree(a, p) serene_Pool_free(a, p, serene_meta(*p))
+
+struct serene_Allocator serene_Pool_dyn(struct serene_Pool*);
+struct serene_Pool serene_Pool_init(struct serene_Allocator backing);
+void* serene_Pool_alloc(void*, struct serene_Ptrmeta);
+void serene_Pool_free(void*, void*, struct serene_Ptrmeta);
+void* serene_Pool_resize(void*, void*, struct serene_Ptrmeta, size_t);
+void serene_Pool_deinit(struct serene_Pool*);
+
+// block size used by serene_Trea_init and inherited by serene_Trea_sub,
+// allocations over a quarter of a block get a block of their own
+#define serene_Trea_block_size 4096
 
 struct serene_Trea_Sub;
+struct serene_Trea_Bin;
 struct serene_Trea {
     struct serene_Allocator backing;
     struct serene_Trea_Sub* current;
+    // shared by a root and all of its subs,
+    // blocks of deinit'ed subs get reused from here
+    struct serene_Trea_Bin* bin;
+    size_t block_size;
+    // optional, inherited by subs
+    struct serene_Stats* stats;
 };
 
 #define serene_trealloc(a, T) ((T*) serene_Trea_alloc(a, serene_meta(T)))
@@ -69,8 +188,33 @@ struct serene_Allocator serene_Trea_dyn(struct serene_Trea*);
 void* serene_Trea_alloc(struct serene_Trea*, struct serene_Ptrmeta);
 void* serene_Trea_dyn_alloc(void*, struct serene_Ptrmeta);
 void serene_Trea_dyn_free(void*, void* ptr, struct serene_Ptrmeta);
+void* serene_Trea_resize(struct serene_Trea*, void*, struct serene_Ptrmeta, size_t);
+void* serene_Trea_dyn_resize(void*, void*, struct serene_Ptrmeta, size_t);
 struct serene_Trea serene_Trea_init(struct serene_Allocator backing);
+struct serene_Trea serene_Trea_init_sized(
+    struct serene_Allocator backing,
+    size_t block_size
+);
 void serene_Trea_deinit(struct serene_Trea);
 struct serene_Trea serene_Trea_sub(struct serene_Trea* root);
+struct serene_Trea serene_Trea_sub_sized(
+    struct serene_Trea* root,
+    size_t block_size
+);
+
+// attributes the Trea's blocks, and everything it allocates from now on,
+// to stats, which gets inherited by its subs
+void serene_Trea_track(struct serene_Trea*, struct serene_Stats*);
+
+// everything allocated after a mark is dropped by resetting to it,
+// subs made after the mark have to be deinit'ed before that
+struct serene_TreaMark {
+    struct serene_Trea_Sub* block;
+    size_t bump;
+    size_t stamp;
+};
+
+struct serene_TreaMark serene_Trea_mark(struct serene_Trea*);
+void serene_Trea_reset(struct serene_Trea*, struct serene_TreaMark);
 
 #endif
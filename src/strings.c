@@ -1,13 +1,16 @@
 #include "./strings.h"
 #include <assert.h>
+#include <fcntl.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
+// tab, newline, form feed, carriage return and space
 bool strings_ascii_whitespace(char c) {
-    char ws[5] = {0x09, 0x0A, 0x0C, 0x0D, 0x20};
-    for (int i = 0; i < 5; i++) {
-        if (ws[i] == c)
-            return true;
-    }
-    return false;
+    return c == 0x20 || (0x09 <= c && c <= 0x0D && c != 0x0B);
 }
 
 bool strings_ascii_digit(char c) { return '0' <= c && c <= '9'; }
@@ -53,30 +56,387 @@ struct String strings_split_first(struct String* this, char del) {
     return (struct String) {0};
 }
 
+uint64_t strings_hash(struct String s) {
+    // eight bytes at a time, multiply and fold
+    const uint64_t k = 0x9E3779B97F4A7C15ull;
+    uint64_t h = s.len * k;
+    size_t i = 0;
+    for (; i + 8 <= s.len; i += 8) {
+        uint64_t w;
+        memcpy(&w, s.str + i, 8);
+        h = (h ^ w) * k;
+        h ^= h >> 29;
+    }
+    uint64_t w = 0;
+    if (i < s.len) memcpy(&w, s.str + i, s.len - i);
+    h = (h ^ w) * k;
+    h ^= h >> 32;
+    h *= k;
+    h ^= h >> 29;
+    return h;
+}
+
+#define Intern_group 8
+#define Intern_empty 0x80
+#define Intern_ones 0x0101010101010101ull
+#define Intern_highs 0x8080808080808080ull
+
+static uint64_t Intern_load_group(const uint8_t* ctrl) {
+    uint64_t group;
+    memcpy(&group, ctrl, Intern_group);
+    return group;
+}
+
+static void Intern_set_ctrl(struct InternShard* this, size_t idx, uint8_t tag) {
+    this->ctrl[idx] = tag;
+    if (idx < Intern_group) this->ctrl[this->cap + idx] = tag;
+}
+
+// first empty slot along the probe sequence of hash
+static size_t Intern_find_empty(struct InternShard* this, uint64_t hash) {
+    size_t mask = this->cap - 1;
+    size_t pos = (hash >> 7) & mask;
+    for (size_t stride = Intern_group;; stride += Intern_group) {
+        uint64_t empty = Intern_load_group(&this->ctrl[pos]) & Intern_highs;
+        if (empty) return (pos + __builtin_ctzll(empty) / 8) & mask;
+        pos = (pos + stride) & mask;
+    }
+}
+
+static void Intern_grow(struct InternShard* this) {
+    size_t old_cap = this->cap;
+    struct InternSlot* old_slots = this->slots;
+    uint8_t* old_ctrl = this->ctrl;
+
+    this->cap = old_cap ? old_cap * 2 : 64;
+    this->ctrl = serene_trenalloc(&this->alloc, this->cap + Intern_group, uint8_t);
+    this->slots = serene_trenalloc(&this->alloc, this->cap, struct InternSlot);
+    assert(this->ctrl && this->slots && "OOM");
+    memset(this->ctrl, Intern_empty, this->cap + Intern_group);
+
+    for (size_t i = 0; i < old_cap; i++) {
+        if (old_ctrl[i] & Intern_empty) continue;
+        size_t idx = Intern_find_empty(this, old_slots[i].hash);
+        Intern_set_ctrl(this, idx, old_slots[i].hash & 0x7f);
+        this->slots[idx] = old_slots[i];
+    }
+}
+
 struct Intern Intern_init(struct serene_Trea alloc) {
-    return (struct Intern) {
+    struct Intern out = {
         .alloc = alloc,
-        .tree = {0},
+        .shards = NULL,
+        .shard_count = 1,
+        .concurrent = false,
+        .names_lock = PTHREAD_MUTEX_INITIALIZER,
+        .len = 0,
+    };
+    out.shards = serene_trealloc(&out.alloc, struct InternShard);
+    assert(out.shards && "OOM");
+    *out.shards = (struct InternShard) {
+        .lock = PTHREAD_MUTEX_INITIALIZER,
+        .alloc = serene_Trea_sub(&out.alloc),
     };
+    return out;
+}
+
+struct Intern Intern_init_concurrent(
+    struct serene_Allocator backing,
+    size_t shards
+) {
+    assert(shards && (shards & (shards - 1)) == 0 && "shards have to be a power of two");
+    struct Intern out = {
+        .alloc = serene_Trea_init(backing),
+        .shards = NULL,
+        .shard_count = shards,
+        .concurrent = true,
+        .backing = backing,
+        .names_lock = PTHREAD_MUTEX_INITIALIZER,
+        .len = 0,
+    };
+    out.shards = serene_trenalloc(&out.alloc, shards, struct InternShard);
+    assert(out.shards && "OOM");
+    for (size_t i = 0; i < shards; i++) {
+        // roots of their own, subs of a shared Trea
+        // would step on each other when getting new blocks
+        out.shards[i] = (struct InternShard) {
+            .lock = PTHREAD_MUTEX_INITIALIZER,
+            .alloc = serene_Trea_init(backing),
+        };
+    }
+    return out;
+}
+
+void Intern_deinit(struct Intern* this) {
+    for (size_t i = 0; i < this->shard_count; i++) {
+        serene_Trea_deinit(this->shards[i].alloc);
+        pthread_mutex_destroy(&this->shards[i].lock);
+    }
+    pthread_mutex_destroy(&this->names_lock);
+    if (this->snapshot) munmap((void*) this->snapshot, this->snapshot_len);
+    if (!this->concurrent) return;
+    for (size_t k = 0; k < Intern_chunks; k++) {
+        if (!this->names[k]) continue;
+        serene_nfree(this->backing, (size_t) 64 << k, this->names[k]);
+    }
+    serene_Trea_deinit(this->alloc);
+}
+
+static size_t Intern_chunk_of(size_t id) {
+    return 57 - __builtin_clzll(id + 64);
+}
+
+// makes room for names[id] if there isn't any yet
+static struct String* Intern_name_slot(struct Intern* this, size_t id) {
+    size_t k = Intern_chunk_of(id);
+    struct String* chunk = atomic_load_explicit(&this->names[k], memory_order_acquire);
+    if (!chunk) {
+        if (this->concurrent) pthread_mutex_lock(&this->names_lock);
+        chunk = atomic_load_explicit(&this->names[k], memory_order_relaxed);
+        if (!chunk) {
+            size_t n = (size_t) 64 << k;
+            chunk = this->concurrent
+                ? serene_nalloc(this->backing, n, struct String)
+                : serene_trenalloc(&this->alloc, n, struct String);
+            assert(chunk && "OOM");
+            atomic_store_explicit(&this->names[k], chunk, memory_order_release);
+        }
+        if (this->concurrent) pthread_mutex_unlock(&this->names_lock);
+    }
+    return &chunk[id + 64 - ((size_t) 64 << k)];
 }
 
 struct String Intern_insert(
     struct Intern* this,
     struct String s
 ) {
-    struct Ordstring *entry =
-        Btrings_search(&this->tree, (struct Ordstring){.str = s.str, .len = s.len});
-    if (entry) return (struct String){entry->str, entry->len};
+    return Intern_name(this, Intern_symbol(this, s));
+}
+
+struct String Intern_name(const struct Intern* this, uint32_t id) {
+    assert(0 < id && id <= this->len && "not a symbol");
+    size_t k = Intern_chunk_of(id);
+    struct String* chunk = atomic_load_explicit(&this->names[k], memory_order_acquire);
+    return chunk[id + 64 - ((size_t) 64 << k)];
+}
+
+// gives s, which has to stay put and not be in the shard yet, the next id
+static uint32_t Intern_shard_place(
+    struct Intern* this,
+    struct InternShard* shard,
+    struct String s,
+    uint64_t hash,
+    bool used
+) {
+    // keep the load under 7/8
+    if ((shard->len + 1) * 8 > shard->cap * 7) Intern_grow(shard);
+
+    uint32_t id = atomic_fetch_add(&this->len, 1) + 1;
+    assert(id && "ran out of symbol ids");
+    // written before the shard lock is let go of,
+    // so whoever finds the slot can also read the name
+    *Intern_name_slot(this, id) = s;
+
+    size_t idx = Intern_find_empty(shard, hash);
+    Intern_set_ctrl(shard, idx, hash & 0x7f);
+    shard->slots[idx] = (struct InternSlot){s.str, s.len, hash, id, used};
+    shard->len++;
+    return id;
+}
 
-    char *new = serene_trenalloc(&this->alloc, 1 + s.len, char);
+static uint32_t Intern_shard_symbol(
+    struct Intern* this,
+    struct InternShard* shard,
+    struct String s,
+    uint64_t hash
+) {
+    uint8_t tag = hash & 0x7f;
+
+    if (shard->cap) {
+        size_t mask = shard->cap - 1;
+        size_t pos = (hash >> 7) & mask;
+        for (size_t stride = Intern_group;; stride += Intern_group) {
+            uint64_t group = Intern_load_group(&shard->ctrl[pos]);
+            // bytes equal to tag become zero, then the usual
+            // has-zero-byte trick, false positives get weeded out below
+            uint64_t x = group ^ (tag * Intern_ones);
+            uint64_t match = (x - Intern_ones) & ~x & Intern_highs;
+            while (match) {
+                size_t idx = (pos + __builtin_ctzll(match) / 8) & mask;
+                struct InternSlot* slot = &shard->slots[idx];
+                if (slot->hash == hash && slot->len == s.len
+                    && memcmp(slot->str, s.str, s.len) == 0) {
+                    slot->used = true;
+                    return slot->id;
+                }
+                match &= match - 1;
+            }
+            if (group & Intern_highs) break;
+            pos = (pos + stride) & mask;
+        }
+    }
+
+    char *new = serene_trenalloc(&shard->alloc, 1 + s.len, char);
     assert(new && "OOM");
-    for (size_t i = 0; i < s.len; i++)
-        new[i] = s.str[i];
+    memcpy(new, s.str, s.len);
     new[s.len] = '\0';
-    assert(Btrings_insert(
-        &this->tree,
-        serene_Trea_dyn(&this->alloc),
-        (struct Ordstring){.str = new, .len = s.len}
-    ));
-    return (struct String){new, s.len};
+    return Intern_shard_place(this, shard, (struct String){new, s.len}, hash, true);
+}
+
+static struct InternShard* Intern_shard_of(struct Intern* this, uint64_t hash) {
+    size_t bits = __builtin_ctzll(this->shard_count);
+    return &this->shards[bits ? hash >> (64 - bits) : 0];
+}
+
+uint32_t Intern_symbol(
+    struct Intern* this,
+    struct String s
+) {
+    uint64_t hash = strings_hash(s);
+    struct InternShard* shard = Intern_shard_of(this, hash);
+    if (!this->concurrent) return Intern_shard_symbol(this, shard, s, hash);
+
+    pthread_mutex_lock(&shard->lock);
+    uint32_t id = Intern_shard_symbol(this, shard, s, hash);
+    pthread_mutex_unlock(&shard->lock);
+    return id;
+}
+
+// the file is a header, one entry per id in order,
+// then all the strings, each followed by a NUL
+struct InternSnapshot {
+    char magic[8];
+    uint32_t version;
+    uint32_t count;
+    uint64_t strings_len;
+};
+
+struct InternSnapshotEntry {
+    uint64_t hash;
+    // from the start of the strings
+    uint32_t offset;
+    uint32_t len;
+};
+
+static const char Intern_magic[8] = "taraint";
+
+bool Intern_save(const struct Intern* this, const char* path) {
+    // names of the snapshot this run never looked up get dropped,
+    // so the cache follows the program instead of growing forever;
+    // the rest keep their order, which keeps the builtins up front
+    struct serene_Allocator libc = serene_Libc_dyn();
+    size_t len = this->len;
+    bool* used = serene_nalloc(libc, len + 1, bool);
+    assert(used && "OOM");
+    memset(used, 0, len + 1);
+    for (size_t i = 0; i < this->shard_count; i++) {
+        struct InternShard* shard = &this->shards[i];
+        for (size_t j = 0; j < shard->cap; j++) {
+            if (shard->ctrl[j] & Intern_empty) continue;
+            used[shard->slots[j].id] = shard->slots[j].used;
+        }
+    }
+
+    struct InternSnapshot head = {
+        .version = Intern_snapshot_version,
+        .count = 0,
+        .strings_len = 0,
+    };
+    memcpy(head.magic, Intern_magic, sizeof(head.magic));
+    for (size_t id = 1; id <= len; id++) {
+        if (!used[id]) continue;
+        head.count++;
+        head.strings_len += Intern_name(this, id).len + 1;
+    }
+    if (head.strings_len > UINT32_MAX) {
+        serene_nfree(libc, len + 1, used);
+        return false;
+    }
+
+    size_t path_len = strlen(path);
+    char tmp[path_len + 5];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+    FILE* file = fopen(tmp, "wb");
+    if (!file) {
+        serene_nfree(libc, len + 1, used);
+        return false;
+    }
+
+    bool ok = fwrite(&head, sizeof(head), 1, file) == 1;
+    uint32_t offset = 0;
+    for (size_t id = 1; ok && id <= len; id++) {
+        if (!used[id]) continue;
+        struct String name = Intern_name(this, id);
+        struct InternSnapshotEntry entry = {
+            .hash = strings_hash(name),
+            .offset = offset,
+            .len = name.len,
+        };
+        ok = fwrite(&entry, sizeof(entry), 1, file) == 1;
+        offset += name.len + 1;
+    }
+    for (size_t id = 1; ok && id <= len; id++) {
+        if (!used[id]) continue;
+        struct String name = Intern_name(this, id);
+        ok = fwrite(name.str, 1, name.len + 1, file) == name.len + 1;
+    }
+    serene_nfree(libc, len + 1, used);
+    if (fclose(file) != 0) ok = false;
+    if (ok) ok = rename(tmp, path) == 0;
+    if (!ok) remove(tmp);
+    return ok;
+}
+
+bool Intern_load(
+    struct Intern* this,
+    const char* path,
+    const struct String* expect,
+    size_t expect_len
+) {
+    assert(this->len == 0 && "can only load into a fresh Intern");
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat stat;
+    if (fstat(fd, &stat) != 0 || (size_t) stat.st_size < sizeof(struct InternSnapshot)) {
+        close(fd);
+        return false;
+    }
+    size_t size = stat.st_size;
+    const char* map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return false;
+
+    // check all of it before touching the Intern
+    const struct InternSnapshot* head = (const void*) map;
+    const struct InternSnapshotEntry* entries = (const void*) (head + 1);
+    bool ok = memcmp(head->magic, Intern_magic, sizeof(head->magic)) == 0
+        && head->version == Intern_snapshot_version
+        && (size - sizeof(*head)) / sizeof(*entries) >= head->count;
+    const char* strings = ok ? (const char*) (entries + head->count) : NULL;
+    ok = ok && (size_t) (map + size - strings) == head->strings_len;
+    for (size_t i = 0; ok && i < head->count; i++) {
+        ok = (uint64_t) entries[i].offset + entries[i].len < head->strings_len
+            && strings[entries[i].offset + entries[i].len] == '\0';
+    }
+    // written by a build that gave out different ids up front
+    ok = ok && head->count >= expect_len;
+    for (size_t i = 0; ok && i < expect_len; i++) {
+        ok = strings_equal(
+            (struct String){&strings[entries[i].offset], entries[i].len}, expect[i]
+        );
+    }
+    if (!ok) {
+        munmap((void*) map, size);
+        return false;
+    }
+
+    for (size_t i = 0; i < head->count; i++) {
+        struct String s = {&strings[entries[i].offset], entries[i].len};
+        struct InternShard* shard = Intern_shard_of(this, entries[i].hash);
+        // fresh and without duplicates, so no need to look first
+        assert(Intern_shard_place(this, shard, s, entries[i].hash, false) == i + 1);
+    }
+    this->snapshot = map;
+    this->snapshot_len = size;
+    return true;
 }
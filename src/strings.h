@@ -1,10 +1,11 @@
 #ifndef STRINGS_H
 #define STRINGS_H
 
-#include "btrings.h"
 #include "serene.h"
+#include <pthread.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 struct String {
     const char* str;
@@ -20,14 +21,81 @@ bool strings_equal(struct String, struct String);
 struct String strings_drop(struct String, unsigned int num);
 struct String strings_split_first(struct String*, char);
 
+// open addressing with one control byte per slot,
+// probed a group of 8 at a time like a swiss table
+struct InternShard {
+    // only taken when the Intern is concurrent
+    pthread_mutex_t lock;
+    // the table and the strings copied into it
+    struct serene_Trea alloc;
+    // high bit set means empty, otherwise the low 7 bits of the hash,
+    // the first group is mirrored past the end so groups can wrap
+    uint8_t* ctrl;
+    struct InternSlot {
+        const char* str;
+        size_t len;
+        uint64_t hash;
+        uint32_t id;
+        // looked up this run, only those get saved
+        bool used;
+    }* slots;
+    size_t cap;
+    size_t len;
+};
+
+// chunk k holds 64 << k names, enough for every 32 bit id
+#define Intern_chunks 27
+
+// strings get spread over the shards by the top bits of their hash,
+// ids are handed out densely from 1 over all shards, 0 is never a symbol
 struct Intern {
-    struct Btrings tree;
     struct serene_Trea alloc;
+    struct InternShard* shards;
+    // a power of two
+    size_t shard_count;
+    bool concurrent;
+    // where the names and the shards get their memory when concurrent
+    struct serene_Allocator backing;
+    pthread_mutex_t names_lock;
+    // names[id] is the string behind an id, kept in chunks that
+    // never move so they can be read while others are inserting
+    struct String* _Atomic names[Intern_chunks];
+    _Atomic size_t len;
+    // mapping of a loaded snapshot, strings of it point in here
+    const char* snapshot;
+    size_t snapshot_len;
 };
 
+uint64_t strings_hash(struct String);
+
 struct Intern Intern_init(struct serene_Trea alloc);
+// safe to insert into from several threads at once, each shard has
+// its own lock and its own Trea, backing has to be safe to share,
+// so wrap it in a serene_Locked if it isn't
+struct Intern Intern_init_concurrent(struct serene_Allocator backing, size_t shards);
+// the interned strings go away with the Intern
+void Intern_deinit(struct Intern *);
 // copies the contents of the passed in string
 // the returned string is owned by Intern
 struct String Intern_insert(struct Intern *, struct String);
+// same as Intern_insert, but hands out the id of the string instead
+uint32_t Intern_symbol(struct Intern *, struct String);
+struct String Intern_name(const struct Intern *, uint32_t);
+
+// bump whenever the layout or strings_hash changes
+#define Intern_snapshot_version 1
+
+// writes every string looked up since the Intern was made or loaded,
+// with its hash and in id order, going through a temporary file
+// so readers never see half of it
+bool Intern_save(const struct Intern *, const char *path);
+// maps a file written by Intern_save into a fresh Intern,
+// giving every string back the same id without copying it;
+// ids 1 to expect_len have to be those names for it to be used,
+// returns false and leaves the Intern alone if it can't be
+bool Intern_load(
+    struct Intern *, const char *path,
+    const struct String* expect, size_t expect_len
+);
 
 #endif
@@ -1,49 +1,98 @@
 #include "./symbols.h"
+#include <assert.h>
+
+#define name(s) {s, sizeof(s) - 1}
+
+const struct String symbols_names[SYM_bint_to_ptr + 1] = {
+    [SYM_main] = name("main"),
+    [SYM_unit] = name("()"),
+    [SYM_int] = name("int"),
+    [SYM_int8] = name("int8"),
+    [SYM_int16] = name("int16"),
+    [SYM_int32] = name("int32"),
+    [SYM_int64] = name("int64"),
+    [SYM_uint] = name("uint"),
+    [SYM_uint8] = name("uint8"),
+    [SYM_uint16] = name("uint16"),
+    [SYM_uint32] = name("uint32"),
+    [SYM_uint64] = name("uint64"),
+    [SYM_bool] = name("bool"),
+    [SYM_true] = name("true"),
+    [SYM_false] = name("false"),
+    [SYM_string] = name("string"),
+    [SYM_star] = name("*"),
+    [SYM_badd] = name("__builtin_add"),
+    [SYM_bsub] = name("__builtin_sub"),
+    [SYM_bmul] = name("__builtin_mul"),
+    [SYM_bdiv] = name("__builtin_div"),
+    [SYM_bmod] = name("__builtin_mod"),
+    [SYM_bneg] = name("__builtin_neg"),
+    [SYM_band] = name("__builtin_and"),
+    [SYM_bor] = name("__builtin_or"),
+    [SYM_bxor] = name("__builtin_xor"),
+    [SYM_bnot] = name("__builtin_not"),
+    [SYM_bshl] = name("__builtin_shl"),
+    [SYM_bshr] = name("__builtin_shr"),
+    [SYM_bcmpEQ] = name("__builtin_cmp_eq"),
+    [SYM_bcmpNE] = name("__builtin_cmp_ne"),
+    [SYM_bcmpGT] = name("__builtin_cmp_gt"),
+    [SYM_bcmpLT] = name("__builtin_cmp_lt"),
+    [SYM_bcmpGE] = name("__builtin_cmp_ge"),
+    [SYM_bcmpLE] = name("__builtin_cmp_le"),
+    [SYM_syscall] = name("__builtin_syscall"),
+    [SYM_bptr_to_int] = name("__builtin_ptr_to_int"),
+    [SYM_bint_to_ptr] = name("__builtin_int_to_ptr"),
+};
+
+#undef name
 
 struct Symbols
 populate_interner(struct Intern *intern) {
-#define ins(s) Intern_insert(intern, (struct String){s, sizeof(s) / sizeof(char) - 1})
+#define ins(id) ( \
+    assert(Intern_symbol(intern, symbols_names[id]) == id), \
+    Intern_name(intern, id))
     struct Symbols out = {0};
+    out.strings = intern;
 
-    out.s_main = ins("main");
-    out.s_unit = ins("()");
-    out.s_int   = ins("int");
-    out.s_int8  = ins("int8");
-    out.s_int16 = ins("int16");
-    out.s_int32 = ins("int32");
-    out.s_int64 = ins("int64");
-    out.s_uint   = ins("uint");
-    out.s_uint8  = ins("uint8");
-    out.s_uint16 = ins("uint16");
-    out.s_uint32 = ins("uint32");
-    out.s_uint64 = ins("uint64");
-    out.s_bool = ins("bool");
-    out.s_true = ins("true");
-    out.s_false = ins("false");
-    out.s_string = ins("string");
-    out.s_star = ins("*");
+    out.s_main = ins(SYM_main);
+    out.s_unit = ins(SYM_unit);
+    out.s_int   = ins(SYM_int);
+    out.s_int8  = ins(SYM_int8);
+    out.s_int16 = ins(SYM_int16);
+    out.s_int32 = ins(SYM_int32);
+    out.s_int64 = ins(SYM_int64);
+    out.s_uint   = ins(SYM_uint);
+    out.s_uint8  = ins(SYM_uint8);
+    out.s_uint16 = ins(SYM_uint16);
+    out.s_uint32 = ins(SYM_uint32);
+    out.s_uint64 = ins(SYM_uint64);
+    out.s_bool = ins(SYM_bool);
+    out.s_true = ins(SYM_true);
+    out.s_false = ins(SYM_false);
+    out.s_string = ins(SYM_string);
+    out.s_star = ins(SYM_star);
 
-    out.s_badd = ins("__builtin_add");
-    out.s_bsub = ins("__builtin_sub");
-    out.s_bmul = ins("__builtin_mul");
-    out.s_bdiv = ins("__builtin_div");
-    out.s_bmod = ins("__builtin_mod");
-    out.s_bneg = ins("__builtin_neg");
-    out.s_band = ins("__builtin_and");
-    out.s_bor = ins("__builtin_or");
-    out.s_bxor = ins("__builtin_xor");
-    out.s_bnot = ins("__builtin_not");
-    out.s_bshl = ins("__builtin_shl");
-    out.s_bshr = ins("__builtin_shr");
-    out.s_bcmpEQ = ins("__builtin_cmp_eq");
-    out.s_bcmpNE = ins("__builtin_cmp_ne");
-    out.s_bcmpGT = ins("__builtin_cmp_gt");
-    out.s_bcmpLT = ins("__builtin_cmp_lt");
-    out.s_bcmpGE = ins("__builtin_cmp_ge");
-    out.s_bcmpLE = ins("__builtin_cmp_le");
-    out.s_syscall = ins("__builtin_syscall");
-    out.s_bptr_to_int = ins("__builtin_ptr_to_int");
-    out.s_bint_to_ptr = ins("__builtin_int_to_ptr");
+    out.s_badd = ins(SYM_badd);
+    out.s_bsub = ins(SYM_bsub);
+    out.s_bmul = ins(SYM_bmul);
+    out.s_bdiv = ins(SYM_bdiv);
+    out.s_bmod = ins(SYM_bmod);
+    out.s_bneg = ins(SYM_bneg);
+    out.s_band = ins(SYM_band);
+    out.s_bor = ins(SYM_bor);
+    out.s_bxor = ins(SYM_bxor);
+    out.s_bnot = ins(SYM_bnot);
+    out.s_bshl = ins(SYM_bshl);
+    out.s_bshr = ins(SYM_bshr);
+    out.s_bcmpEQ = ins(SYM_bcmpEQ);
+    out.s_bcmpNE = ins(SYM_bcmpNE);
+    out.s_bcmpGT = ins(SYM_bcmpGT);
+    out.s_bcmpLT = ins(SYM_bcmpLT);
+    out.s_bcmpGE = ins(SYM_bcmpGE);
+    out.s_bcmpLE = ins(SYM_bcmpLE);
+    out.s_syscall = ins(SYM_syscall);
+    out.s_bptr_to_int = ins(SYM_bptr_to_int);
+    out.s_bint_to_ptr = ins(SYM_bint_to_ptr);
 
     return out;
 #undef ins
@@ -4,7 +4,56 @@
 #include "./strings.h"
 #include "serene.h"
 
+// populate_interner fills a fresh interner, so these are the ids
+// its symbols end up with, the builtins are kept contiguous
+// and in the same order as enum tst_ExprBuiltin
+enum Symbol {
+    SYM_None = 0,
+    SYM_main,
+    SYM_unit,
+    SYM_int,
+    SYM_int8,
+    SYM_int16,
+    SYM_int32,
+    SYM_int64,
+    SYM_uint,
+    SYM_uint8,
+    SYM_uint16,
+    SYM_uint32,
+    SYM_uint64,
+    SYM_bool,
+    SYM_true,
+    SYM_false,
+    SYM_string,
+    SYM_star,
+
+    SYM_badd,
+    SYM_bsub,
+    SYM_bmul,
+    SYM_bdiv,
+    SYM_bmod,
+    SYM_bneg,
+    SYM_band,
+    SYM_bor,
+    SYM_bxor,
+    SYM_bnot,
+    SYM_bshl,
+    SYM_bshr,
+    SYM_bcmpEQ,
+    SYM_bcmpNE,
+    SYM_bcmpGT,
+    SYM_bcmpLT,
+    SYM_bcmpGE,
+    SYM_bcmpLE,
+    SYM_syscall,
+    SYM_bptr_to_int,
+    SYM_bint_to_ptr,
+};
+
 struct Symbols {
+    // for sizing tables indexed by symbol id
+    struct Intern* strings;
+
     struct String s_unit;
     struct String s_int;
     struct String s_int8;
@@ -46,6 +95,10 @@ struct Symbols {
     struct String s_bint_to_ptr;
 };
 
+// the name of each of the ids above, a loaded intern snapshot
+// has to start with them to be of any use
+extern const struct String symbols_names[SYM_bint_to_ptr + 1];
+
 struct Symbols populate_interner(struct Intern *);
 
 #endif
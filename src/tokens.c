@@ -1,46 +1,190 @@
 #include "./tokens.h"
 #include "./strings.h"
+#include <assert.h>
 #include <stdio.h>
+#include <string.h>
+
+static_assert(TK_Comment <= UINT8_MAX, "token kinds are stored in a byte");
+
+bool Tokens_reserve(struct Tokens* this, size_t cap) {
+    if (cap <= this->cap) return true;
+    uint8_t* kinds = this->kinds
+        ? serene_nresize(this->alloc, this->kinds, this->cap, cap)
+        : serene_nalloc(this->alloc, cap, uint8_t);
+    if (!kinds) return false;
+    this->kinds = kinds;
+    uint32_t* syms = this->syms
+        ? serene_nresize(this->alloc, this->syms, this->cap, cap)
+        : serene_nalloc(this->alloc, cap, uint32_t);
+    if (!syms) return false;
+    this->syms = syms;
+    this->cap = cap;
+    return true;
+}
+
+static bool Tokens_push_number(struct Tokens* this, struct Literal number) {
+    if (this->numbers_len >= this->numbers_cap) {
+        size_t cap = this->numbers_cap ? this->numbers_cap * 2 : 16;
+        struct Literal* numbers = this->numbers
+            ? serene_nresize(this->alloc, this->numbers, this->numbers_cap, cap)
+            : serene_nalloc(this->alloc, cap, struct Literal);
+        if (!numbers) return false;
+        this->numbers = numbers;
+        this->numbers_cap = cap;
+    }
+    this->numbers[this->numbers_len++] = number;
+    return true;
+}
+
+bool Tokens_push(struct Tokens* this, struct Token token) {
+    if (this->len >= this->cap && !Tokens_reserve(this, this->cap ? this->cap * 2 : 16)) {
+        return false;
+    }
+    if (token.kind == TK_Number && !Tokens_push_number(this, token.number)) {
+        return false;
+    }
+    this->kinds[this->len] = token.kind;
+    this->syms[this->len] = token.sym;
+    this->len++;
+    return true;
+}
+
+bool Tokens_append(struct Tokens* this, const struct Tokens* other) {
+    if (!Tokens_reserve(this, this->len + other->len)) return false;
+    if (this->numbers_len + other->numbers_len > this->numbers_cap) {
+        size_t cap = this->numbers_len + other->numbers_len;
+        struct Literal* numbers = this->numbers
+            ? serene_nresize(this->alloc, this->numbers, this->numbers_cap, cap)
+            : serene_nalloc(this->alloc, cap, struct Literal);
+        if (!numbers) return false;
+        this->numbers = numbers;
+        this->numbers_cap = cap;
+    }
+    if (other->len) {
+        memcpy(&this->kinds[this->len], other->kinds, other->len);
+        memcpy(&this->syms[this->len], other->syms, sizeof(uint32_t) * other->len);
+    }
+    if (other->numbers_len) {
+        memcpy(
+            &this->numbers[this->numbers_len], other->numbers,
+            sizeof(struct Literal) * other->numbers_len
+        );
+    }
+    this->len += other->len;
+    this->numbers_len += other->numbers_len;
+    return true;
+}
+
+void Tokens_deinit(struct Tokens* this) {
+    if (this->kinds) serene_nfree(this->alloc, this->cap, this->kinds);
+    if (this->syms) serene_nfree(this->alloc, this->cap, this->syms);
+    if (this->numbers) serene_nfree(this->alloc, this->numbers_cap, this->numbers);
+    *this = (struct Tokens){0};
+}
+
+struct Tokenstream Tokens_stream(const struct Tokens* this, const struct Intern* intern) {
+    return (struct Tokenstream){
+        .kinds = this->kinds,
+        .syms = this->syms,
+        .numbers = this->numbers,
+        .len = this->len,
+        .intern = intern,
+    };
+}
+
+struct Tokenstream Tokenstream_pulling(struct Token (*pull)(void*), void* ctx) {
+    return (struct Tokenstream){
+        .pull = pull,
+        .pull_ctx = ctx,
+    };
+}
+
+// the token n ahead of a pulling stream, pulling up to it
+static struct Token* Tokenstream_ring_at(struct Tokenstream* this, unsigned n) {
+    assert(n < Tokenstream_lookahead && "peeking too far ahead");
+    while (this->ring_len <= n) {
+        unsigned at = (this->ring_head + this->ring_len) % Tokenstream_lookahead;
+        this->ring[at] = this->pull(this->pull_ctx);
+        this->ring_len++;
+    }
+    return &this->ring[(this->ring_head + n) % Tokenstream_lookahead];
+}
+
+static bool Tokenstream_at_end(struct Tokenstream* this) {
+    if (this->pull) return Tokenstream_ring_at(this, 0)->kind == TK_EOF;
+    return this->len <= 0;
+}
+
+static void Tokenstream_advance(struct Tokenstream* this) {
+    if (this->pull) {
+        Tokenstream_ring_at(this, 0);
+        this->ring_head = (this->ring_head + 1) % Tokenstream_lookahead;
+        this->ring_len--;
+        return;
+    }
+    if (this->kinds[0] == TK_Number) this->numbers++;
+    this->kinds++;
+    this->syms++;
+    this->len--;
+}
+
+static const char* Tokenstream_spelling(struct Tokenstream* this) {
+    return Tokenstream_peek(this).spelling.str;
+}
 
 bool Tokenstream_drop(struct Tokenstream* this) {
-    if (this->len <= 0) {
+    if (Tokenstream_at_end(this)) {
         printf("Unexpected eof!\n");
         return false;
     }
-    this->buf++;
-    this->len--;
+    Tokenstream_advance(this);
     return true;
 }
 
 bool Tokenstream_drop_text(struct Tokenstream* this, struct String text) {
-    if (this->len <= 0) {
+    if (Tokenstream_at_end(this)) {
         printf("Unexpected eof!\n");
         return false;
     }
-    if (!strings_equal(this->buf[0].spelling, text)) {
-        printf("Unexpected token: '%s'!\n", this->buf[0].spelling.str);
+    if (!strings_equal(Tokenstream_peek(this).spelling, text)) {
+        printf("Unexpected token: '%s'!\n", Tokenstream_spelling(this));
         return false;
     }
-    this->buf++;
-    this->len--;
+    Tokenstream_advance(this);
     return true;
 }
 
 bool Tokenstream_drop_kind(struct Tokenstream* this, enum Tokenkind kind) {
-    if (this->len <= 0) {
+    if (Tokenstream_at_end(this)) {
         printf("Unexpected eof!\n");
         return false;
     }
-    if (this->buf[0].kind != kind) {
-        printf("Unexpected token: '%s'!\n", this->buf[0].spelling.str);
+    if (Tokenstream_peek_kind(this) != kind) {
+        printf("Unexpected token: '%s'!\n", Tokenstream_spelling(this));
         return false;
     }
-    this->buf++;
-    this->len--;
+    Tokenstream_advance(this);
     return true;
 }
 
 struct Token Tokenstream_peek(struct Tokenstream* this) {
+    if (this->pull) return *Tokenstream_ring_at(this, 0);
     if (this->len <= 0) return (struct Token) {0};
-    return this->buf[0];
+    struct Token out = {
+        .kind = this->kinds[0],
+        .sym = this->syms[0],
+        .spelling = Intern_name(this->intern, this->syms[0]),
+    };
+    if (out.kind == TK_Number) out.number = this->numbers[0];
+    return out;
+}
+
+enum Tokenkind Tokenstream_peek_kind(struct Tokenstream* this) {
+    return Tokenstream_peek_kind_at(this, 0);
+}
+
+enum Tokenkind Tokenstream_peek_kind_at(struct Tokenstream* this, unsigned n) {
+    if (this->pull) return Tokenstream_ring_at(this, n)->kind;
+    if (this->len <= n) return TK_EOF;
+    return this->kinds[n];
 }
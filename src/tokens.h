@@ -3,7 +3,9 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
+#include "literals.h"
 #include "strings.h"
 
 enum Tokenkind {
@@ -46,18 +48,60 @@ enum Tokenkind {
 
 struct Token {
     enum Tokenkind kind;
+    // symbol id of the interned spelling, 0 before scanning
+    uint32_t sym;
     struct String spelling;
-    int number;
+    struct Literal number;
 };
 
+// scanned tokens, kept as parallel arrays since the parser mostly
+// only looks at kinds; the spelling is the interned name of sym,
+// and numbers carry their value in a side table, in token order
+struct Tokens {
+    uint8_t* kinds;
+    uint32_t* syms;
+    size_t len;
+    size_t cap;
+    struct Literal* numbers;
+    size_t numbers_len;
+    size_t numbers_cap;
+    struct serene_Allocator alloc;
+};
+
+bool Tokens_reserve(struct Tokens*, size_t);
+bool Tokens_push(struct Tokens*, struct Token);
+bool Tokens_append(struct Tokens*, const struct Tokens*);
+void Tokens_deinit(struct Tokens*);
+
+// how far ahead a pulled Tokenstream can be peeked, a power of two
+#define Tokenstream_lookahead 4
+
 struct Tokenstream {
-    struct Token *buf;
+    const uint8_t* kinds;
+    const uint32_t* syms;
+    const struct Literal* numbers;
     size_t len;
+    const struct Intern* intern;
+    // when set tokens are pulled from it on demand instead,
+    // into a ring holding just the ones peeked at so far
+    struct Token (*pull)(void*);
+    void* pull_ctx;
+    struct Token ring[Tokenstream_lookahead];
+    unsigned ring_head;
+    unsigned ring_len;
 };
 
+struct Tokenstream Tokens_stream(const struct Tokens*, const struct Intern*);
+// pull returns TK_EOF once it runs out, and keeps doing so
+struct Tokenstream Tokenstream_pulling(struct Token (*pull)(void*), void* ctx);
+
 bool Tokenstream_drop(struct Tokenstream*);
 bool Tokenstream_drop_text(struct Tokenstream*, struct String);
 bool Tokenstream_drop_kind(struct Tokenstream*, enum Tokenkind);
 struct Token Tokenstream_peek(struct Tokenstream*);
+// TK_EOF at the end
+enum Tokenkind Tokenstream_peek_kind(struct Tokenstream*);
+// the kind n tokens ahead, n < Tokenstream_lookahead
+enum Tokenkind Tokenstream_peek_kind_at(struct Tokenstream*, unsigned n);
 
 #endif
@@ -54,6 +54,7 @@ struct tst_Binding {
     union {
         struct {
             struct String name;
+            uint32_t sym;
             struct tst_Type type;
         } name;
         struct tst_BindingTuple *tuple;
@@ -115,6 +116,8 @@ enum tst_ExprBuiltin {
 
 struct tst_Expr {
     enum tst_ExprTag tag;
+    // symbol id of lit, for recalls and literals
+    uint32_t sym;
     struct tst_Type type;
     union {
         struct tst_ExprIf *if_expr;
@@ -123,7 +126,11 @@ struct tst_Expr {
         struct tst_Expr *loop;
         struct tst_ExprsLL* bareblock;
         enum tst_ExprBuiltin builtin;
-        struct String lit;
+        struct {
+            struct String lit;
+            // number literals' value, as an index into the Literals
+            uint32_t literal;
+        };
 
         struct tst_ExprLet* let;
         struct tst_ExprAssign *assign;
@@ -156,11 +163,13 @@ struct tst_ExprLet {
 };
 struct tst_ExprAssign {
     struct String name;
+    uint32_t sym;
     struct tst_Expr expr;
 };
 
 struct tst_Function {
     struct String name;
+    uint32_t sym;
     struct tst_Type type;
     struct tst_Binding args;
     struct tst_Expr body;
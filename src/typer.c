@@ -18,7 +18,7 @@ struct DSet {
     } *types;
 };
 
-static struct TypeLL *DSet_insert(struct serene_Trea*, struct DSet *, Type);
+static struct TypeLL *DSet_insert(struct serene_Pool*, struct DSet *, Type);
 static struct TypeLL *DSet_root(struct TypeLL *);
 static struct TypeLL *DSet_find_root(struct DSet *, Type);
 static struct TypeLL *DSet_join(struct TypeLL *, struct TypeLL *);
@@ -27,22 +27,21 @@ static void DSet_print(struct DSet *);
 struct Globals {
     struct TypeIntern* intern;
     struct serene_Trea* alloc;
-    struct GlobalsLL {
-        struct GlobalsLL *next;
-        struct {
-            struct String name;
-            Type type;
-        } current;
-    } *globals;
+    // small nodes that come and go while checking a function
+    struct serene_Pool* nodes;
+    // types of the top level names by symbol id, NULL if there's none,
+    // only up to the largest id declared by the module or its imports
+    Type *globals;
+    size_t len;
 };
 
-static Type unify(struct serene_Trea*, struct TypeIntern*, struct DSet *, Type, Type);
+static Type unify(struct serene_Pool*, struct TypeIntern*, struct DSet *, Type, Type);
 static void typecheck_func(struct Globals, struct Function *);
 
 struct Context {
     struct LetsLL {
         struct {
-            struct String name;
+            uint32_t sym;
             bool mutable;
             Type type;
         } current;
@@ -63,13 +62,19 @@ static void fill_binding(struct Context *, struct Binding *);
 static Type fill_type(struct Context *, Type);
 static Type destructure_binding(struct Context *, struct Binding *, bool);
 
-static void typecheck_top(struct TypeIntern*, struct Ast*, struct PPImports*);
+static void typecheck_top(
+    struct TypeIntern*,
+    struct Ast*,
+    struct PPImports*,
+    struct serene_Stats*
+);
+
+void typecheck_module(struct PTData* data, struct serene_Stats* stats) {
+    typecheck_top(&data->types, &data->ast, data->imports, stats);
+}
 
-static void* typecheck_ptr(void* _ctx, void* _data) {
-    (void)_ctx;
-    struct PTData* data = _data;
-    if (!data) return data;
-    typecheck_top(&data->types, &data->ast, data->imports);
+static void* typecheck_ptr(void* _ctx, void* data) {
+    if (data) typecheck_module(data, _ctx);
     return data;
 }
 
@@ -77,19 +82,40 @@ static void cleanup(void* _data) {
     (void)_data;
 }
 
-void typecheck(struct MTree* mods) {
-    MTree_map(mods, cleanup, typecheck_ptr, NULL);
+void typecheck(struct MTree* mods, struct serene_Stats* stats) {
+    MTree_map(mods, cleanup, typecheck_ptr, stats);
 }
 
 static void typecheck_top(
     struct TypeIntern* intern,
     struct Ast* ast,
-    struct PPImports* imports
+    struct PPImports* imports,
+    struct serene_Stats* stats
 ) {
     struct serene_Trea alloc = serene_Trea_sub(intern->alloc);
+    if (stats) serene_Trea_track(&alloc, stats);
     struct Globals globals = {0};
     globals.intern = intern;
     globals.alloc = &alloc;
+    {
+        // sizing it by the whole intern would cost every module
+        // a table as big as all the names of the program
+        uint32_t max = SYM_bint_to_ptr;
+        for (ll_iter(i, imports)) {
+            struct PTData* data = i->current.mod->data;
+            if (!data) continue;
+            for (ll_iter(f, data->ast.funcs)) {
+                if (f->current.sym > max) max = f->current.sym;
+            }
+        }
+        for (ll_iter(f, ast->funcs)) {
+            if (f->current.sym > max) max = f->current.sym;
+        }
+        globals.len = (size_t) max + 1;
+        globals.globals = serene_trenalloc(&alloc, globals.len, Type);
+        assert(globals.globals && "OOM");
+        for (size_t i = 0; i < globals.len; i++) globals.globals[i] = NULL;
+    }
 
     {
         Type t_int = intern->tsyms.t_int;
@@ -98,11 +124,13 @@ static void typecheck_top(
         Type string_to_int = Type_func(intern, t_string, t_int);
         Type int_to_string = Type_func(intern, t_int, t_string);
         struct String t_name = intern->syms.s_main;
-        Type t_type = Type_recall(intern, t_name);
+        uint32_t t_sym = SYM_main;
+        Type t_type = Type_recall(intern, t_name, t_sym);
         Type t2 = Type_call(intern, intern->tsyms.t_star, Type_tuple(intern, t_type, t_type));
         Type forall_t2_to_t = Type_forall(
             intern,
             t_name,
+            t_sym,
             Type_func(
                 intern,
                 t2,
@@ -112,6 +140,7 @@ static void typecheck_top(
         Type forall_t2_to_bool = Type_forall(
             intern,
             t_name,
+            t_sym,
             Type_func(
                 intern,
                 t2,
@@ -121,6 +150,7 @@ static void typecheck_top(
         Type forall_t_to_t = Type_forall(
             intern,
             t_name,
+            t_sym,
             Type_func(intern, t_type, t_type)
         );
         Type int7_to_int;
@@ -135,40 +165,35 @@ static void typecheck_top(
             int7_to_int = Type_func(globals.intern, tint7, t_int);
         }
         struct {
-            struct String name;
+            uint32_t sym;
             Type type;
         } builtins[] = {
-            {.name = intern->syms.s_badd, .type = forall_t2_to_t},
-            {.name = intern->syms.s_bsub, .type = forall_t2_to_t},
-            {.name = intern->syms.s_bmul, .type = forall_t2_to_t},
-            {.name = intern->syms.s_bdiv, .type = forall_t2_to_t},
-            {.name = intern->syms.s_bmod, .type = forall_t2_to_t},
-            {.name = intern->syms.s_band, .type = forall_t2_to_t},
-            {.name = intern->syms.s_bor, .type = forall_t2_to_t},
-            {.name = intern->syms.s_bxor, .type = forall_t2_to_t},
-            {.name = intern->syms.s_bshl, .type = forall_t2_to_t},
-            {.name = intern->syms.s_bshr, .type = forall_t2_to_t},
-            {.name = intern->syms.s_bnot, .type = forall_t_to_t},
-            {.name = intern->syms.s_bneg, .type = forall_t_to_t},
-            {.name = intern->syms.s_bcmpEQ, .type = forall_t2_to_bool},
-            {.name = intern->syms.s_bcmpNE, .type = forall_t2_to_bool},
-            {.name = intern->syms.s_bcmpGT, .type = forall_t2_to_bool},
-            {.name = intern->syms.s_bcmpLT, .type = forall_t2_to_bool},
-            {.name = intern->syms.s_bcmpGE, .type = forall_t2_to_bool},
-            {.name = intern->syms.s_bcmpLE, .type = forall_t2_to_bool},
-            {.name = intern->syms.s_syscall, .type = int7_to_int},
+            {.sym = SYM_badd, .type = forall_t2_to_t},
+            {.sym = SYM_bsub, .type = forall_t2_to_t},
+            {.sym = SYM_bmul, .type = forall_t2_to_t},
+            {.sym = SYM_bdiv, .type = forall_t2_to_t},
+            {.sym = SYM_bmod, .type = forall_t2_to_t},
+            {.sym = SYM_band, .type = forall_t2_to_t},
+            {.sym = SYM_bor, .type = forall_t2_to_t},
+            {.sym = SYM_bxor, .type = forall_t2_to_t},
+            {.sym = SYM_bshl, .type = forall_t2_to_t},
+            {.sym = SYM_bshr, .type = forall_t2_to_t},
+            {.sym = SYM_bnot, .type = forall_t_to_t},
+            {.sym = SYM_bneg, .type = forall_t_to_t},
+            {.sym = SYM_bcmpEQ, .type = forall_t2_to_bool},
+            {.sym = SYM_bcmpNE, .type = forall_t2_to_bool},
+            {.sym = SYM_bcmpGT, .type = forall_t2_to_bool},
+            {.sym = SYM_bcmpLT, .type = forall_t2_to_bool},
+            {.sym = SYM_bcmpGE, .type = forall_t2_to_bool},
+            {.sym = SYM_bcmpLE, .type = forall_t2_to_bool},
+            {.sym = SYM_syscall, .type = int7_to_int},
             // currently only strings are ptrs
             // in the future this should become a generic builtin
-            {.name = intern->syms.s_bptr_to_int, .type = string_to_int},
-            {.name = intern->syms.s_bint_to_ptr, .type = int_to_string},
+            {.sym = SYM_bptr_to_int, .type = string_to_int},
+            {.sym = SYM_bint_to_ptr, .type = int_to_string},
         };
         for (unsigned int i = 0; i < sizeof(builtins) / sizeof(builtins[0]); i++) {
-            struct GlobalsLL* tmp = serene_trealloc(&alloc, struct GlobalsLL);
-            assert(tmp && "OOM");
-            tmp->current.type = builtins[i].type;
-            tmp->current.name = builtins[i].name;
-            tmp->next = globals.globals;
-            globals.globals = tmp;
+            globals.globals[builtins[i].sym] = builtins[i].type;
         }
     }
 
@@ -180,43 +205,26 @@ static void typecheck_top(
         }
         if (strings_equal(i->current.decl, (struct String){"...", 3})) {
             for (ll_iter(f, data->ast.funcs)) {
-                struct GlobalsLL *tmp = serene_trealloc(&alloc, struct GlobalsLL);
-                assert(tmp);
-
                 Type ret = f->current.ret;
                 Type args = Binding_to_type(globals.intern, f->current.args);
-                tmp->current.type = Type_func(globals.intern, args, ret);
-                tmp->current.name = f->current.name;
-                tmp->next = globals.globals;
-                globals.globals = tmp;
+                globals.globals[f->current.sym] = Type_func(globals.intern, args, ret);
             }
             continue;
         }
         for (ll_iter(f, data->ast.funcs)) {
             if (f->current.name.str != i->current.decl.str) continue;
 
-            struct GlobalsLL *tmp = serene_trealloc(&alloc, struct GlobalsLL);
-            assert(tmp && "OOM"), ZERO(*tmp);
             Type ret = f->current.ret;
             Type args = Binding_to_type(globals.intern, f->current.args);
-            tmp->current.type = Type_func(globals.intern, args, ret);
-            tmp->current.name = f->current.name;
-            tmp->next = globals.globals;
-            globals.globals = tmp;
+            globals.globals[f->current.sym] = Type_func(globals.intern, args, ret);
             break;
         }
     }
 
     for (ll_iter(f, ast->funcs)) {
-        struct GlobalsLL *tmp = serene_trealloc(&alloc, struct GlobalsLL);
-        assert(tmp);
-
         Type ret = f->current.ret;
         Type args = Binding_to_type(globals.intern, f->current.args);
-        tmp->current.type = Type_func(globals.intern, args, ret);
-        tmp->current.name = f->current.name;
-        tmp->next = globals.globals;
-        globals.globals = tmp;
+        globals.globals[f->current.sym] = Type_func(globals.intern, args, ret);
     }
 
     for (ll_iter(f, ast->funcs)) {
@@ -227,12 +235,17 @@ static void typecheck_top(
 }
 
 static void typecheck_func(struct Globals globals, struct Function *func) {
+    // nothing in here outlives the function,
+    // so the next one gets to reuse the same memory
+    struct serene_TreaMark mark = serene_Trea_mark(globals.alloc);
+    struct serene_Pool nodes = serene_Pool_init(serene_Trea_dyn(globals.alloc));
+    globals.nodes = &nodes;
     struct Context ctx = {0};
     ctx.globals = globals;
     destructure_binding(&ctx, &func->args, false);
     ctx.ret = func->ret;
     unify(
-        globals.alloc, ctx.globals.intern, &ctx.equivs, func->ret, typecheck_expr(&ctx, &func->body)
+        globals.nodes, ctx.globals.intern, &ctx.equivs, func->ret, typecheck_expr(&ctx, &func->body)
     );
 
     DSet_print(&ctx.equivs);
@@ -241,6 +254,9 @@ static void typecheck_func(struct Globals globals, struct Function *func) {
     printf("\n\n");
 
     fill_expr(&ctx, &func->body);
+
+    serene_Pool_deinit(&nodes);
+    serene_Trea_reset(globals.alloc, mark);
 }
 
 static Type typecheck_ET_If(struct Context* ctx, struct ExprIf* expr),
@@ -251,7 +267,7 @@ static Type typecheck_ET_If(struct Context* ctx, struct ExprIf* expr),
         Type type
     ),
     typecheck_ET_Call(struct Context* ctx, struct ExprCall* expr, Type type),
-    typecheck_ET_Recall(struct Context* ctx, struct String lit, Type type),
+    typecheck_ET_Recall(struct Context* ctx, struct Expr* expr),
     typecheck_ST_Assign(
         struct Context *ctx, struct ExprAssign *expr, Type type
     ),
@@ -260,7 +276,7 @@ static Type typecheck_ET_If(struct Context* ctx, struct ExprIf* expr),
     typecheck_ST_Mut(struct Context *ctx, struct ExprLet *let, Type type),
     typecheck_ST_Let(struct Context *ctx, struct ExprLet *let, Type type),
     typecheck_ET_Tuple(struct Context *ctx, struct ExprTuple expr, Type type),
-    typecheck_ET_Recall(struct Context *ctx, struct String lit, Type type);
+    typecheck_ET_Recall(struct Context *ctx, struct Expr *expr);
 
 static Type typecheck_expr(struct Context *ctx, struct Expr *expr) {
 #define Case(Tag, ...)                                                         \
@@ -272,7 +288,7 @@ static Type typecheck_expr(struct Context *ctx, struct Expr *expr) {
         Case(ET_Loop, expr->loop, expr->type);
         Case(ET_Bareblock, expr->bareblock, expr->type);
         Case(ET_Call, expr->call, expr->type);
-        Case(ET_Recall, expr->lit, expr->type);
+        Case(ET_Recall, expr);
         Case(ET_Tuple, expr->tuple, expr->type);
 
         Case(ST_Let, expr->let, expr->type);
@@ -298,37 +314,40 @@ static Type typecheck_expr(struct Context *ctx, struct Expr *expr) {
 static Type typecheck_ET_If(struct Context *ctx, struct ExprIf *expr) {
     Type cond = typecheck_expr(ctx, &expr->cond);
     unify(
-        ctx->globals.alloc,
+        ctx->globals.nodes,
         ctx->globals.intern,
         &ctx->equivs, cond,
         ctx->globals.intern->tsyms.t_bool
     );
     Type smash = typecheck_expr(ctx, &expr->smash);
     Type pass = typecheck_expr(ctx, &expr->pass);
-    return unify(ctx->globals.alloc, ctx->globals.intern, &ctx->equivs, smash, pass);
+    return unify(ctx->globals.nodes, ctx->globals.intern, &ctx->equivs, smash, pass);
 }
 
 static Type typecheck_ET_Loop(struct Context *ctx, struct Expr *body, Type type) {
-    struct LoopsLL *head = serene_trealloc(ctx->globals.alloc, struct LoopsLL);
+    struct LoopsLL *head = serene_poolalloc(ctx->globals.nodes, struct LoopsLL);
+    assert(head && "OOM");
     head->current = type;
     head->next = ctx->loops;
     ctx->loops = head;
     typecheck_expr(ctx, body);
     ctx->loops = head->next;
+    serene_poolfree(ctx->globals.nodes, head);
     return type;
 }
 
 static Type
 typecheck_ET_Bareblock(struct Context *ctx, struct ExprsLL *body, Type type) {
-    // TODO: we should probably also revert arena state
-    // so as to free up the memory that is 'leaked' here
-    // that is however complicated, as the arena is used
-    // for many things beyond ctx->lets
     struct LetsLL *head = ctx->lets;
     for (ll_iter(s, body)) {
         typecheck_expr(ctx, &s->current);
     }
-    ctx->lets = head;
+    // the lets of this block go out of scope
+    while (ctx->lets != head) {
+        struct LetsLL *tmp = ctx->lets;
+        ctx->lets = tmp->next;
+        serene_poolfree(ctx->globals.nodes, tmp);
+    }
     return type;
 }
 
@@ -338,31 +357,29 @@ static Type typecheck_ET_Call(struct Context* ctx, struct ExprCall* expr, Type t
     a = typecheck_expr(ctx, &expr->args);
     r = type;
     Type fa = Type_func(ctx->globals.intern, a, r);
-    Type p = unify(ctx->globals.alloc, ctx->globals.intern, &ctx->equivs, f, fa);
+    Type p = unify(ctx->globals.nodes, ctx->globals.intern, &ctx->equivs, f, fa);
     assert(p->tag == TT_Func);
     return p->func.ret;
 }
 
-static Type typecheck_ET_Recall(struct Context *ctx, struct String lit, Type type) {
+static Type typecheck_ET_Recall(struct Context *ctx, struct Expr *expr) {
     for (ll_iter(head, ctx->lets)) {
-        if (head->current.name.str == lit.str) {
+        if (head->current.sym == expr->sym) {
             return unify(
-                ctx->globals.alloc,
+                ctx->globals.nodes,
                 ctx->globals.intern,
-                &ctx->equivs, type, head->current.type
+                &ctx->equivs, expr->type, head->current.type
             );
         }
     }
-    for (ll_iter(head, ctx->globals.globals)) {
-        if (head->current.name.str == lit.str) {
-            return unify(
-                ctx->globals.alloc,
-                ctx->globals.intern,
-                &ctx->equivs, type, head->current.type
-            );
-        }
+    if (expr->sym < ctx->globals.len && ctx->globals.globals[expr->sym]) {
+        return unify(
+            ctx->globals.nodes,
+            ctx->globals.intern,
+            &ctx->equivs, expr->type, ctx->globals.globals[expr->sym]
+        );
     }
-    printf("\nno name such as '%.*s'!\n", (int) lit.len, lit.str);
+    printf("\nno name such as '%.*s'!\n", (int) expr->lit.len, expr->lit.str);
     assert(false);
 }
 
@@ -381,26 +398,26 @@ static Type typecheck_ST_Let(struct Context* ctx, struct ExprLet* let, Type type
     (void) type;
     Type it = typecheck_expr(ctx, &let->init);
     Type bt = destructure_binding(ctx, &let->bind, false);
-    return unify(ctx->globals.alloc, ctx->globals.intern, &ctx->equivs, it, bt);
+    return unify(ctx->globals.nodes, ctx->globals.intern, &ctx->equivs, it, bt);
 }
 
 static Type typecheck_ST_Mut(struct Context* ctx, struct ExprLet* let, Type type) {
     (void) type;
     Type it = typecheck_expr(ctx, &let->init);
     Type bt = destructure_binding(ctx, &let->bind, true);
-    return unify(ctx->globals.alloc, ctx->globals.intern, &ctx->equivs, it, bt);
+    return unify(ctx->globals.nodes, ctx->globals.intern, &ctx->equivs, it, bt);
 }
 
 static Type typecheck_ST_Break(struct Context *ctx, struct Expr *body, Type type) {
     Type brk = typecheck_expr(ctx, body);
     assert(ctx->loops);
-    unify(ctx->globals.alloc, ctx->globals.intern, &ctx->equivs, brk, ctx->loops->current);
+    unify(ctx->globals.nodes, ctx->globals.intern, &ctx->equivs, brk, ctx->loops->current);
     return type;
 }
 
 static Type typecheck_ST_Return(struct Context *ctx, struct Expr *body, Type type) {
     Type ret = typecheck_expr(ctx, body);
-    unify(ctx->globals.alloc, ctx->globals.intern, &ctx->equivs, ret, ctx->ret);
+    unify(ctx->globals.nodes, ctx->globals.intern, &ctx->equivs, ret, ctx->ret);
     return type;
 }
 
@@ -411,13 +428,13 @@ static Type typecheck_ST_Assign(
 ) {
     (void)type;
     for (ll_iter(head, ctx->lets)) {
-        if (head->current.name.str == expr->name.str) {
+        if (head->current.sym == expr->sym) {
             assert(
                 head->current.mutable && "tried modifying an immutable var!"
             );
             Type ass = typecheck_expr(ctx, &expr->expr);
             return unify(
-                ctx->globals.alloc, ctx->globals.intern, &ctx->equivs, ass, head->current.type
+                ctx->globals.nodes, ctx->globals.intern, &ctx->equivs, ass, head->current.type
             );
         }
     }
@@ -520,7 +537,7 @@ static void fill_binding(struct Context *ctx, struct Binding *binding) {
 static Type fill_TT_Func(struct Context* ctx, struct TypeFunc type),
     fill_TT_Call(struct Context* ctx, struct TypeCall type),
     fill_TT_Tuple(struct Context* ctx, const struct TypeTuple* type),
-    fill_TT_Forall(struct Context* ctx, const struct TypeForall* type),
+    fill_TT_Forall(struct Context* ctx, Type whole),
     fill_TT_Var(struct Context *ctx, Type whole);
 
 static Type fill_type(struct Context *ctx, Type type) {
@@ -529,7 +546,7 @@ static Type fill_type(struct Context *ctx, Type type) {
         return fill_##Tag(ctx, __VA_ARGS__);
 
     switch (type->tag) {
-        Case(TT_Forall, &type->forall);
+        Case(TT_Forall, type);
         Case(TT_Func, type->func);
         Case(TT_Call, type->call);
         Case(TT_Tuple, type->tuple);
@@ -543,9 +560,9 @@ static Type fill_type(struct Context *ctx, Type type) {
     assert(false && "shouldn't");
 }
 
-static Type fill_TT_Forall(struct Context* ctx, const struct TypeForall* type) {
-    Type in = fill_type(ctx, type->in);
-    return Type_forall(ctx->globals.intern, type->binding, in);
+static Type fill_TT_Forall(struct Context* ctx, Type whole) {
+    Type in = fill_type(ctx, whole->forall.in);
+    return Type_forall(ctx->globals.intern, whole->forall.binding, whole->sym, in);
 }
 
 static Type fill_TT_Func(struct Context *ctx, struct TypeFunc type) {
@@ -564,7 +581,9 @@ static Type fill_TT_Tuple(struct Context* ctx, const struct TypeTuple* type) {
     struct TypeTuple* list = NULL;
     struct TypeTuple* last = NULL;
     for (ll_iter(head, type)) {
-        struct TypeTuple* tmp = serene_trealloc(ctx->globals.alloc, struct TypeTuple);
+        // the nodes end up in the interned type,
+        // so they can't live in the scratch Trea
+        struct TypeTuple* tmp = serene_trealloc(ctx->globals.intern->alloc, struct TypeTuple);
         assert(tmp && "OOM");
         *tmp = (struct TypeTuple){0};
         tmp->current = fill_type(ctx, head->current);
@@ -592,9 +611,9 @@ static Type destructure_binding(
         case BT_Empty:
             return binding->empty;
         case BT_Name: {
-            struct LetsLL* tmp = serene_trealloc(ctx->globals.alloc, struct LetsLL);
+            struct LetsLL* tmp = serene_poolalloc(ctx->globals.nodes, struct LetsLL);
             assert(tmp);
-            tmp->current.name = binding->name.name;
+            tmp->current.sym = binding->name.sym;
             tmp->current.mutable = mut;
             tmp->current.type = binding->name.annot;
             tmp->next = ctx->lets;
@@ -616,23 +635,23 @@ static Type destructure_binding(
 static Type index_generics(
     struct TypeIntern* intern,
     Type body,
-    struct String name,
+    uint32_t sym,
     Type arg
 ) {
     switch (body->tag) {
     case TT_Forall: assert(false && "why");
     case TT_Func: {
-        Type args = index_generics(intern, body->func.args, name, arg);
-        Type ret = index_generics(intern, body->func.ret, name, arg);
+        Type args = index_generics(intern, body->func.args, sym, arg);
+        Type ret = index_generics(intern, body->func.ret, sym, arg);
         return Type_func(intern, args, ret);
     }
     case TT_Call: {
-        Type _name = index_generics(intern, body->call.name, name, arg);
-        Type args = index_generics(intern, body->call.args, name, arg);
+        Type _name = index_generics(intern, body->call.name, sym, arg);
+        Type args = index_generics(intern, body->call.args, sym, arg);
         return Type_call(intern, _name, args);
     }
     case TT_Recall: {
-        if (strings_equal(name, body->recall)) return arg;
+        if (body->sym == sym) return arg;
         return body;
     }
     case TT_Tuple: {
@@ -641,7 +660,7 @@ static Type index_generics(
         for (const struct TypeTuple* head = body->tuple; head; head = head->next) {
             struct TypeTuple* tmp = serene_trealloc(intern->alloc, struct TypeTuple);
             assert(tmp && "OOM"), ZERO(*tmp);
-            tmp->current = index_generics(intern, head->current, name, arg);
+            tmp->current = index_generics(intern, head->current, sym, arg);
             if (!last) tuple = tmp;
             else last->next = tmp;
             last = tmp;
@@ -658,15 +677,15 @@ static Type index_generics(
 }
 
 static Type unify(
-    struct serene_Trea* alloc,
+    struct serene_Pool* nodes,
     struct TypeIntern* intern,
     struct DSet* dset,
     Type lhs,
     Type rhs
 ) {
-    struct TypeLL* lroot = DSet_root(DSet_insert(alloc, dset, lhs));
+    struct TypeLL* lroot = DSet_root(DSet_insert(nodes, dset, lhs));
     Type ltype = lroot->current.type;
-    struct TypeLL *rroot = DSet_root(DSet_insert(alloc, dset, rhs));
+    struct TypeLL *rroot = DSet_root(DSet_insert(nodes, dset, rhs));
     Type rtype = rroot->current.type;
     if (rtype->tag == TT_Forall) {
         Type tmp = rtype;
@@ -680,24 +699,24 @@ static Type unify(
                 ltype = index_generics(
                     intern,
                     ltype->forall.in,
-                    ltype->forall.binding,
+                    ltype->sym,
                     Type_new_typevar(intern)
                     );
-                return unify(alloc, intern, dset, ltype, rtype);
+                return unify(nodes, intern, dset, ltype, rtype);
             }
             case TT_Call:
-                unify(alloc, intern, dset, ltype->call.name, rtype->call.name);
-                unify(alloc, intern, dset, ltype->call.args, rtype->call.args);
+                unify(nodes, intern, dset, ltype->call.name, rtype->call.name);
+                unify(nodes, intern, dset, ltype->call.args, rtype->call.args);
                 return lroot->current.type;
             case TT_Func:
-                unify(alloc, intern, dset, ltype->func.args, rtype->func.args);
-                unify(alloc, intern, dset, ltype->func.ret, rtype->func.ret);
+                unify(nodes, intern, dset, ltype->func.args, rtype->func.args);
+                unify(nodes, intern, dset, ltype->func.ret, rtype->func.ret);
                 return ltype;
             case TT_Tuple: {
                 const struct TypeTuple* lhead = ltype->tuple;
                 const struct TypeTuple* rhead = rtype->tuple;
                 while (lhead && rhead) {
-                    unify(alloc, intern, dset, lhead->current, rhead->current);
+                    unify(nodes, intern, dset, lhead->current, rhead->current);
                     lhead = lhead->next;
                     rhead = rhead->next;
                 }
@@ -705,7 +724,7 @@ static Type unify(
                 return ltype;
             }
             case TT_Recall:
-                assert(ltype->recall.str == rtype->recall.str && "type mismatch");
+                assert(ltype->sym == rtype->sym && "type mismatch");
                 return ltype;
             case TT_Var:
                 break;
@@ -722,7 +741,7 @@ static Type unify(
     return DSet_join(lroot, rroot)->current.type;
 }
 
-static struct TypeLL* DSet_insert(struct serene_Trea* alloc, struct DSet *this, Type type) {
+static struct TypeLL* DSet_insert(struct serene_Pool* nodes, struct DSet *this, Type type) {
     for (ll_iter(head, this->types)) {
         if (head->current.type == type)
             return head;
@@ -732,7 +751,7 @@ static struct TypeLL* DSet_insert(struct serene_Trea* alloc, struct DSet *this,
     Type_print(type);
     printf("\n");
 
-    struct TypeLL *tmp = serene_trealloc(alloc, struct TypeLL);
+    struct TypeLL *tmp = serene_poolalloc(nodes, struct TypeLL);
     assert(tmp && "OOM");
     tmp->next = this->types;
     tmp->current.parent = tmp;
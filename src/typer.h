@@ -7,6 +7,10 @@
 #include "mtree.h"
 #include "serene.h"
 
-void typecheck(struct MTree*);
+// stats may be NULL
+void typecheck(struct MTree*, struct serene_Stats* stats);
+struct PTData;
+// a single module, its imports have to be typechecked already
+void typecheck_module(struct PTData*, struct serene_Stats* stats);
 
 #endif
@@ -1,7 +1,11 @@
 #include "typereg.h"
+#include <stdint.h>
 #include <string.h>
 #include <assert.h>
 #include <stdio.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 #define tmove(dst, src, num, T)  {                      \
         T* __dst__ = dst;                               \
@@ -15,22 +19,60 @@
         memcpy(__dst__, __src__, sizeof(T) * (num));    \
     }
 
+// prefixes[i] is Type_prefix(keys[i]), they are kept up front
+// so that a search only touches the first cache lines of a node
 struct Typereg_impl {
-    struct Typereg_impl *subs[32 + 1];
+    uint32_t prefixes[32];
+    int len;
     struct Typereg_impl *parent;
+    struct Typereg_impl *subs[32 + 1];
     struct Type* keys[32];
-    int len;
 };
 
+// how many of the sorted prefixes are below p
+static int impl_below(const uint32_t *prefixes, int len, uint32_t p) {
+    int i = 0;
+#ifdef __SSE2__
+    // there's no unsigned compare, flipping the sign bit makes do
+    const __m128i flip = _mm_set1_epi32(INT32_MIN);
+    const __m128i needle = _mm_xor_si128(_mm_set1_epi32(p), flip);
+    for (; i + 4 <= len; i += 4) {
+        __m128i chunk = _mm_loadu_si128((const __m128i *) &prefixes[i]);
+        __m128i less = _mm_cmplt_epi32(_mm_xor_si128(chunk, flip), needle);
+        int mask = _mm_movemask_ps(_mm_castsi128_ps(less));
+        if (mask != 0xf) return i + __builtin_popcount(mask);
+    }
+#endif
+    while (i < len && prefixes[i] < p) i++;
+    return i;
+}
+
+// index of the first key not below elem, diff is its Type_cmp against elem;
+// only keys sharing elem's prefix need a full compare
+static int impl_lower(
+    struct Typereg_impl *this, struct Type* elem, uint32_t p, int *diff
+) {
+    int i = impl_below(this->prefixes, this->len, p);
+    for (; i < this->len && this->prefixes[i] == p; i++) {
+        *diff = Type_cmp(this->keys[i], elem);
+        if (*diff >= 0) return i;
+    }
+    *diff = 1;
+    return i;
+}
+
+static void impl_refresh(struct Typereg_impl *this, int from) {
+    for (int i = from; i < this->len; i++) {
+        this->prefixes[i] = Type_prefix(this->keys[i]);
+    }
+}
+
 static struct Typereg_impl *impl_goto(
-    struct Typereg_impl *this, struct Type* elem
+    struct Typereg_impl *this, struct Type* elem, uint32_t p
 ) {
+    int diff;
     while (this->subs[0]) {
-        int i = 0;
-        while (
-            i < this->len && Type_cmp(this->keys[i], elem) < 0
-        ) i++;
-        this = this->subs[i];
+        this = this->subs[impl_lower(this, elem, p, &diff)];
     }
     return this;
 }
@@ -42,10 +84,8 @@ static bool impl_input(
     bool is_node = this->subs[0] != NULL;
     bool is_full = this->len >= 32;
 
-    int i = 0;
-    while (
-        i < this->len && Type_cmp(this->keys[i], *elem) < 0
-    ) i++; 
+    int diff;
+    int i = impl_lower(this, *elem, Type_prefix(*elem), &diff);
 
     if (!is_full) {
         tmove(&this->keys[i+1], &this->keys[i], this->len-i, struct Type*);
@@ -58,6 +98,7 @@ static bool impl_input(
         }
 
         this->len++;
+        impl_refresh(this, i);
         *node = NULL;
         return true;
     }
@@ -85,8 +126,10 @@ static bool impl_input(
         tcopy(&this->subs[0], &subs[0], m+1, struct Typereg_impl*);
         for (int j = 0; j < m+1; j++) this->subs[j]->parent = this;
         tcopy(&new->subs[0], &subs[m+1], 32+1-m, struct Typereg_impl*);
-        for (int j = 0; j < 32+1-m; j++) new->subs[j]->parent = *node;
+        for (int j = 0; j < 32+1-m; j++) new->subs[j]->parent = new;
     }
+    impl_refresh(this, i < m ? i : m);
+    impl_refresh(new, 0);
 
     *node = new;
     *elem = keys[m];
@@ -97,7 +140,7 @@ static struct Typereg_impl *impl_insert(
     struct Typereg_impl *this, struct serene_Allocator alloc,
     struct Type* elem
 ) {
-    struct Typereg_impl *leaf = impl_goto(this, elem);
+    struct Typereg_impl *leaf = impl_goto(this, elem, Type_prefix(elem));
     struct Typereg_impl *node = NULL;
     do {
         if (!impl_input(leaf, alloc, &elem, &node)) return NULL;
@@ -111,6 +154,7 @@ static struct Typereg_impl *impl_insert(
     *root = (struct Typereg_impl) {
         .parent = NULL,
         .len = 1,
+        .prefixes = {Type_prefix(elem)},
         .keys = {elem},
         .subs = {this, node},
     };
@@ -143,20 +187,76 @@ static void impl_deinit(struct Typereg_impl *this, struct serene_Allocator alloc
     serene_free(alloc, this);
 }
 
+// builds the tree bottom up, one level at a time, out of strictly ascending elems;
+// unlike repeated inserts this fills every node evenly
+bool Typereg_from_sorted(
+    struct Typereg *this, struct serene_Allocator alloc,
+    struct Type* const *elems, size_t len
+) {
+    assert(!this->root && "only an empty tree can be bulk loaded");
+    if (len == 0) return true;
+    for (size_t i = 1; i < len; i++) {
+        assert(Type_cmp(elems[i-1], elems[i]) < 0 && "bulk load needs sorted input");
+    }
+
+    // the keys between the nodes of one level become the keys of the next,
+    // both arrays get compacted in place as the levels shrink
+    struct Type* *keys = serene_nalloc(alloc, len, struct Type*);
+    struct Typereg_impl **nodes = serene_nalloc(alloc, len, struct Typereg_impl*);
+    bool ok = keys && nodes;
+    if (ok) memcpy(keys, elems, sizeof(struct Type*) * len);
+
+    bool leaves = true;
+    // children of every node on this level, for leaves the gaps between keys
+    size_t width = len + 1;
+    while (ok) {
+        size_t count = (width + 32) / (32 + 1);
+        size_t k = 0, c = 0;
+        for (size_t j = 0; j < count; j++) {
+            size_t take = width / count + (j < width % count);
+            struct Typereg_impl *node = serene_alloc(alloc, struct Typereg_impl);
+            if (!node) {
+                for (size_t i = 0; i < j; i++) impl_deinit(nodes[i], alloc);
+                for (size_t i = c; !leaves && i < width; i++) impl_deinit(nodes[i], alloc);
+                ok = false;
+                break;
+            }
+            *node = (struct Typereg_impl) {0};
+            node->len = take - 1;
+            tcopy(&node->keys[0], &keys[k], take - 1, struct Type*);
+            impl_refresh(node, 0);
+            k += take - 1;
+            if (!leaves) {
+                tcopy(&node->subs[0], &nodes[c], take, struct Typereg_impl*);
+                for (size_t i = 0; i < take; i++) node->subs[i]->parent = node;
+            }
+            c += take;
+            if (j + 1 < count) keys[j] = keys[k++];
+            nodes[j] = node;
+        }
+        if (ok && count == 1) {
+            this->root = nodes[0];
+            break;
+        }
+        width = count;
+        leaves = false;
+    }
+
+    if (keys) serene_nfree(alloc, len, keys);
+    if (nodes) serene_nfree(alloc, len, nodes);
+    return ok;
+}
+
 void Typereg_deinit(struct Typereg *this, struct serene_Allocator alloc) {
     if (!this->root) return;
     impl_deinit(this->root, alloc);
 }
 
 static struct Type* *impl_search(struct Typereg_impl *this, struct Type* elem) {
+    uint32_t p = Type_prefix(elem);
     while (this) {
-        int diff = -1;
-        int i = 0;
-        while (i < this->len) {
-            diff = Type_cmp(this->keys[i], elem);
-            if (diff >= 0) break;
-            i++;
-        }
+        int diff;
+        int i = impl_lower(this, elem, p, &diff);
         if (diff == 0) return &this->keys[i];
         this = this->subs[i];
     }
@@ -168,6 +268,45 @@ struct Type* *Typereg_search(struct Typereg *this, struct Type* elem) {
     return impl_search(this->root, elem);
 }
 
+static struct Typereg_impl *impl_leftmost(struct Typereg_impl *this) {
+    while (this->subs[0]) this = this->subs[0];
+    return this;
+}
+
+struct Typereg_iter Typereg_first(struct Typereg *this) {
+    struct Typereg_iter out = {0};
+    if (!this->root) return out;
+    out.node = impl_leftmost(this->root);
+    if (out.node->len == 0) out.node = NULL;
+    return out;
+}
+
+struct Type* *Typereg_next(struct Typereg_iter *this) {
+    struct Typereg_impl *node = this->node;
+    if (!node) return NULL;
+    struct Type* *out = &node->keys[this->i];
+    if (node->subs[0]) {
+        this->node = impl_leftmost(node->subs[this->i + 1]);
+        this->i = 0;
+        return out;
+    }
+    if (++this->i < node->len) return out;
+    // climb until coming up from the left of some key
+    while (node->parent) {
+        struct Typereg_impl *parent = node->parent;
+        int j = 0;
+        while (parent->subs[j] != node) j++;
+        if (j < parent->len) {
+            this->node = parent;
+            this->i = j;
+            return out;
+        }
+        node = parent;
+    }
+    this->node = NULL;
+    return out;
+}
+
 static void impl_print(struct Typereg_impl *this, int level) {
     if (this->subs[0] != NULL) {
         for (int i = 0; i < this->len; i++) {
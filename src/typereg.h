@@ -12,8 +12,22 @@ struct Typereg {
 };
 
 bool Typereg_insert(struct Typereg *, struct serene_Allocator, struct Type*);
+// elems have to be strictly ascending and the tree empty
+bool Typereg_from_sorted(
+    struct Typereg *, struct serene_Allocator, struct Type* const *, size_t
+);
 struct Type* *Typereg_search(struct Typereg *, struct Type*);
 void Typereg_deinit(struct Typereg *, struct serene_Allocator);
+
+// walks the keys in ascending order, next returns NULL past the last one;
+// inserting invalidates it
+struct Typereg_iter {
+    struct Typereg_impl *node;
+    int i;
+};
+
+struct Typereg_iter Typereg_first(struct Typereg *);
+struct Type* *Typereg_next(struct Typereg_iter *);
 void Typereg_print(struct Typereg *);
 
 #endif
@@ -8,10 +8,7 @@ int Type_cmp(const struct Type *a, const struct Type *b) {
 
     switch (a->tag) {
     case TT_Forall:
-        diff = a->forall.binding.len - b->forall.binding.len;
-        if (diff) return diff;
-        diff = a->forall.binding.str - b->forall.binding.str;
-        if (diff) return diff;
+        if (a->sym != b->sym) return a->sym < b->sym ? -1 : 1;
         return Type_cmp(a->forall.in, b->forall.in);
     case TT_Func:
         diff = Type_cmp(a->func.args, b->func.args);
@@ -33,9 +30,8 @@ int Type_cmp(const struct Type *a, const struct Type *b) {
         return ahead - bhead;
     }
     case TT_Recall:
-        diff = a->recall.len - b->recall.len;
-        if (diff) return diff;
-        return a->recall.str - b->recall.str;
+        if (a->sym != b->sym) return a->sym < b->sym ? -1 : 1;
+        return 0;
     case TT_Var:
         return a->var - b->var;
     }
@@ -43,6 +39,23 @@ int Type_cmp(const struct Type *a, const struct Type *b) {
     assert(0 && "no gcc, control doesn't reach here");
 }
 
+// the tag in the top bits, then whatever the compare looks at
+// right after it, clamped so the order survives
+uint32_t Type_prefix(const struct Type *this) {
+    uint32_t out = (uint32_t) this->tag << 29;
+    uint32_t max = ((uint32_t) 1 << 29) - 1;
+    switch (this->tag) {
+    case TT_Forall:
+    case TT_Recall:
+        return out | (this->sym < max ? this->sym : max);
+    case TT_Var:
+        if (this->var < 0) return out;
+        return out | ((uint32_t) this->var < max ? (uint32_t) this->var : max);
+    default:
+        return out;
+    }
+}
+
 void Type_print(const struct Type *this) {
     switch (this->tag) {
     case TT_Forall:
@@ -31,6 +31,9 @@ struct TypeTuple {
 
 struct Type {
     enum TypeTag tag;
+    // symbol id of recall, or of the binding of a forall,
+    // which is what identifies them
+    uint32_t sym;
     union {
         struct TypeForall forall;
         struct TypeFunc func;
@@ -42,6 +45,8 @@ struct Type {
 };
 
 int Type_cmp(const struct Type *, const struct Type *);
+// a < b whenever prefix(a) < prefix(b), equal ones need the full compare
+uint32_t Type_prefix(const struct Type *);
 void Type_print(const struct Type *);
 
 #endif
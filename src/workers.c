@@ -0,0 +1,130 @@
+#include "./workers.h"
+#include <assert.h>
+
+static void workers_push(struct Workers* this, struct WorkersQueue* queue, struct WorkersTask task) {
+    pthread_mutex_lock(&queue->lock);
+    if (queue->len >= queue->cap) {
+        size_t cap = queue->cap ? queue->cap * 2 : 16;
+        struct WorkersTask* buf = serene_nalloc(this->alloc, cap, struct WorkersTask);
+        assert(buf && "OOM");
+        // unwrapped on the way, so the oldest ends up at the front
+        for (size_t i = 0; i < queue->len; i++) {
+            buf[i] = queue->buf[(queue->head + i) % queue->cap];
+        }
+        if (queue->buf) serene_nfree(this->alloc, queue->cap, queue->buf);
+        queue->buf = buf;
+        queue->head = 0;
+        queue->cap = cap;
+    }
+    queue->buf[(queue->head + queue->len) % queue->cap] = task;
+    queue->len++;
+    pthread_mutex_unlock(&queue->lock);
+}
+
+// the newest task off a worker's own queue, or failing that
+// the oldest one of the first other worker that has any
+static bool workers_take(struct Workers* this, unsigned id, struct WorkersTask* out) {
+    for (unsigned i = 0; i < this->count; i++) {
+        struct WorkersQueue* queue = &this->queues[(id + i) % this->count];
+        pthread_mutex_lock(&queue->lock);
+        bool found = queue->len > 0;
+        if (found && i == 0) {
+            *out = queue->buf[(queue->head + queue->len - 1) % queue->cap];
+            queue->len--;
+        } else if (found) {
+            *out = queue->buf[queue->head];
+            queue->head = (queue->head + 1) % queue->cap;
+            queue->len--;
+        }
+        pthread_mutex_unlock(&queue->lock);
+        if (!found) continue;
+        pthread_mutex_lock(&this->lock);
+        this->queued--;
+        pthread_mutex_unlock(&this->lock);
+        return true;
+    }
+    return false;
+}
+
+static void* workers_run(void* _self) {
+    struct WorkersThread* self = _self;
+    struct Workers* this = self->pool;
+    while (true) {
+        struct WorkersTask task;
+        if (workers_take(this, self->id, &task)) {
+            task.run(task.arg, self->id);
+            pthread_mutex_lock(&this->lock);
+            if (--this->pending == 0) pthread_cond_broadcast(&this->done);
+            pthread_mutex_unlock(&this->lock);
+            continue;
+        }
+        pthread_mutex_lock(&this->lock);
+        // queued can be ahead of the queues while a submit is underway,
+        // in which case this just goes around again
+        while (this->queued == 0 && !this->stopping) {
+            pthread_cond_wait(&this->wake, &this->lock);
+        }
+        bool stop = this->queued == 0 && this->stopping;
+        pthread_mutex_unlock(&this->lock);
+        if (stop) return NULL;
+    }
+}
+
+void Workers_init(struct Workers* this, struct serene_Allocator alloc, unsigned count) {
+    assert(count > 0 && "no workers to run anything");
+    *this = (struct Workers){
+        .alloc = alloc,
+        .count = count,
+        .queues = serene_nalloc(alloc, count, struct WorkersQueue),
+        .threads = serene_nalloc(alloc, count, struct WorkersThread),
+    };
+    assert(this->queues && this->threads && "OOM");
+    pthread_mutex_init(&this->lock, NULL);
+    pthread_cond_init(&this->wake, NULL);
+    pthread_cond_init(&this->done, NULL);
+    for (unsigned i = 0; i < count; i++) {
+        this->queues[i] = (struct WorkersQueue){0};
+        pthread_mutex_init(&this->queues[i].lock, NULL);
+    }
+    for (unsigned i = 0; i < count; i++) {
+        this->threads[i] = (struct WorkersThread){.pool = this, .id = i};
+        assert(pthread_create(&this->threads[i].thread, NULL, workers_run, &this->threads[i]) == 0);
+    }
+}
+
+void Workers_submit(struct Workers* this, struct WorkersTask task) {
+    pthread_mutex_lock(&this->lock);
+    this->queued++;
+    this->pending++;
+    unsigned at = this->next;
+    this->next = (this->next + 1) % this->count;
+    pthread_mutex_unlock(&this->lock);
+    workers_push(this, &this->queues[at], task);
+    pthread_mutex_lock(&this->lock);
+    pthread_cond_signal(&this->wake);
+    pthread_mutex_unlock(&this->lock);
+}
+
+void Workers_wait(struct Workers* this) {
+    pthread_mutex_lock(&this->lock);
+    while (this->pending > 0) pthread_cond_wait(&this->done, &this->lock);
+    pthread_mutex_unlock(&this->lock);
+}
+
+void Workers_deinit(struct Workers* this) {
+    pthread_mutex_lock(&this->lock);
+    this->stopping = true;
+    pthread_cond_broadcast(&this->wake);
+    pthread_mutex_unlock(&this->lock);
+    for (unsigned i = 0; i < this->count; i++) pthread_join(this->threads[i].thread, NULL);
+    for (unsigned i = 0; i < this->count; i++) {
+        struct WorkersQueue* queue = &this->queues[i];
+        if (queue->buf) serene_nfree(this->alloc, queue->cap, queue->buf);
+        pthread_mutex_destroy(&queue->lock);
+    }
+    serene_nfree(this->alloc, this->count, this->queues);
+    serene_nfree(this->alloc, this->count, this->threads);
+    pthread_mutex_destroy(&this->lock);
+    pthread_cond_destroy(&this->wake);
+    pthread_cond_destroy(&this->done);
+}
@@ -0,0 +1,57 @@
+#ifndef WORKERS_H
+#define WORKERS_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "serene.h"
+
+// runs on whichever worker picks it up, worker is its index
+// so tasks can keep per worker state in plain arrays
+struct WorkersTask {
+    void (*run)(void* arg, unsigned worker);
+    void* arg;
+};
+
+// a thread pool where each worker has a queue of its own,
+// tasks get handed out round robin, a worker runs its own newest first
+// and, once it runs dry, steals the oldest of somebody else's
+struct Workers {
+    struct serene_Allocator alloc;
+    unsigned count;
+    struct WorkersQueue {
+        pthread_mutex_t lock;
+        struct WorkersTask* buf;
+        size_t head;
+        size_t len;
+        size_t cap;
+    }* queues;
+    struct WorkersThread {
+        pthread_t thread;
+        struct Workers* pool;
+        unsigned id;
+    }* threads;
+    // the queue the next submitted task goes to
+    unsigned next;
+
+    // guards the counts, idle workers sleep on wake
+    // and Workers_wait on done
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    pthread_cond_t done;
+    // tasks sitting in a queue, and ones that haven't finished yet
+    size_t queued;
+    size_t pending;
+    bool stopping;
+};
+
+// in place, since the threads hold on to it
+void Workers_init(struct Workers*, struct serene_Allocator, unsigned count);
+void Workers_submit(struct Workers*, struct WorkersTask);
+// until every task submitted so far has run,
+// not to be called from a task
+void Workers_wait(struct Workers*);
+void Workers_deinit(struct Workers*);
+
+#endif
@@ -12,8 +12,22 @@ struct @treename@ {
 };
 
 bool @treename@_insert(struct @treename@ *, struct serene_Allocator, @basetype@);
+// elems have to be strictly ascending and the tree empty
+bool @treename@_from_sorted(
+    struct @treename@ *, struct serene_Allocator, @basetype@ const *, size_t
+);
 @basetype@ *@treename@_search(struct @treename@ *, @basetype@);
 void @treename@_deinit(struct @treename@ *, struct serene_Allocator);
+
+// walks the keys in ascending order, next returns NULL past the last one;
+// inserting invalidates it
+struct @treename@_iter {
+    struct @treename@_impl *node;
+    int i;
+};
+
+struct @treename@_iter @treename@_first(struct @treename@ *);
+@basetype@ *@treename@_next(struct @treename@_iter *);
 void @treename@_print(struct @treename@ *);
 
 #endif
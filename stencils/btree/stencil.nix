@@ -5,13 +5,14 @@
   basetype,
   branching,
   cmp,
+  prefix,
   print,
   treename,
   filename,
 }: let
   include = builtins.baseNameOf include-path;
 in pkgs.stdenv.mkDerivation {
-  inherit basetype branching cmp print treename filename include;
+  inherit basetype branching cmp prefix print treename filename include;
   name = filename;
   src = pkgs.lib.fileset.toSource {
     root = ./..;
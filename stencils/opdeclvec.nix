@@ -1,5 +1,5 @@
-{ pkgs }: import ./vec/stencil.nix {
-  inherit pkgs;
+{ pkgs, serene }: import ./vec/stencil.nix {
+  inherit pkgs serene;
   include-path = ./opdecl.h;
   basetype = "struct Opdecl";
   vecname = "Opdecls";
@@ -4,6 +4,7 @@
   basetype = "struct Ordstring";
   branching = 32;
   cmp = "Ordstring_cmp";
+  prefix = "Ordstring_prefix";
   print = "Ordstring_print";
   treename = "Btrings";
   filename = "btrings";
@@ -4,6 +4,7 @@
   basetype = "struct Type *";
   branching = 32;
   cmp = "Type_cmp";
+  prefix = "Type_prefix";
   print = "Type_print";
   treename = "Typereg";
   filename = "typereg";
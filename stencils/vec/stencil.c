@@ -1,5 +1,5 @@
 #include "@filename@.h"
-#include <stdlib.h>
+#include <string.h>
 
 @basetype@ *@vecname@_at(struct @vecname@ *this, size_t idx) {
     if (!this->buf) return NULL;
@@ -7,26 +7,36 @@
     return this->buf + idx;
 }
 
-bool @vecname@_init(struct @vecname@ *this) {
-    if (this->buf) return false;
-    @basetype@ *buf = malloc(4 * sizeof(@basetype@));
+static bool @vecname@_realloc(struct @vecname@ *this, size_t cap) {
+    if (!this->alloc.alloc) this->alloc = serene_Libc_dyn();
+    @basetype@ *buf;
+    if (this->buf) {
+        buf = serene_nresize(this->alloc, this->buf, this->cap, cap);
+    } else {
+        buf = serene_nalloc(this->alloc, cap, @basetype@);
+    }
     if (!buf) return false;
     this->buf = buf;
-    this->cap = 4;
-    this->len = 0;
+    this->cap = cap;
     return true;
 }
 
+bool @vecname@_init(struct @vecname@ *this) {
+    if (this->buf) return false;
+    this->len = 0;
+    return @vecname@_realloc(this, 4);
+}
+
 bool @vecname@_grow(struct @vecname@ *this) {
     if (!this->buf) return @vecname@_init(this);
-    @basetype@ *buf = malloc(2 * this->cap * sizeof(@basetype@));
-    if (!buf) return false;
-    for (size_t i = 0; i < this->len; i++)
-        buf[i] = this->buf[i];
-    free(this->buf);
-    this->cap *= 2;
-    this->buf = buf;
-    return true;
+    return @vecname@_realloc(this, 2 * this->cap);
+}
+
+bool @vecname@_reserve(struct @vecname@ *this, size_t n) {
+    if (this->buf && @vecname@_space(this) >= n) return true;
+    size_t cap = this->cap ? this->cap : 4;
+    while (cap - this->len < n) cap *= 2;
+    return @vecname@_realloc(this, cap);
 }
 
 bool @vecname@_push(struct @vecname@ *this, @basetype@ elem) {
@@ -36,6 +46,16 @@ bool @vecname@_push(struct @vecname@ *this, @basetype@ elem) {
     return true;
 }
 
+bool @vecname@_extend(
+    struct @vecname@ *this, const @basetype@ *elems, size_t n
+) {
+    if (n == 0) return true;
+    if (!@vecname@_reserve(this, n)) return false;
+    memcpy(this->buf + this->len, elems, n * sizeof(@basetype@));
+    this->len += n;
+    return true;
+}
+
 @basetype@ *@vecname@_first(struct @vecname@ *this) {
     if (this->len == 0) return NULL;
     return this->buf;
@@ -54,7 +74,7 @@ bool @vecname@_push(struct @vecname@ *this, @basetype@ elem) {
 }
 
 void @vecname@_deinit(struct @vecname@ *this) {
-    free(this->buf);
+    if (this->buf) serene_nfree(this->alloc, this->cap, this->buf);
     this->buf = NULL;
     this->len = 0;
     this->cap = 0;
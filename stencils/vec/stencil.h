@@ -2,6 +2,7 @@
 #define @filename@_H
 
 #include "@include@"
+#include "serene.h"
 #include <stdbool.h>
 #include <stddef.h>
 
@@ -9,12 +10,16 @@ struct @vecname@ {
     size_t len;
     size_t cap;
     @basetype@ *buf;
+    // left zeroed it falls back to libc
+    struct serene_Allocator alloc;
 };
 
 @basetype@ *@vecname@_at(struct @vecname@ *, size_t);
 bool @vecname@_init(struct @vecname@ *);
 bool @vecname@_grow(struct @vecname@ *);
+bool @vecname@_reserve(struct @vecname@ *, size_t);
 bool @vecname@_push(struct @vecname@ *, @basetype@);
+bool @vecname@_extend(struct @vecname@ *, const @basetype@ *, size_t);
 @basetype@ *@vecname@_first(struct @vecname@ *);
 @basetype@ *@vecname@_last(struct @vecname@ *);
 @basetype@ *@vecname@_emplace(struct @vecname@ *);
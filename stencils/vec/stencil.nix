@@ -1,5 +1,6 @@
 {
   pkgs,
+  serene,
   include-path,
   basetype,
   vecname,
@@ -16,6 +17,7 @@ in pkgs.stdenv.mkDerivation {
       include-path
     ];
   };
+  buildInputs = [ serene ];
   buildPhase = ''
     substituteAll $src/vec/stencil.h ./${filename}.h
     substituteAll $src/vec/stencil.c ./stencil.c